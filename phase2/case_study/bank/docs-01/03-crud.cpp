@@ -3,6 +3,19 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <atomic>
+#include <utility>
+#include <exception>
+#include <fcntl.h>
+#include <unistd.h>
 
 class BankAccount {
 private:
@@ -38,10 +51,11 @@ public:
     char name[255];
     bool active;
     int transCount;
+    bool deleted;   // tombstone, dropped by BankAccountRepo::compact
 
 public:
     // Default constructor
-    FileBankAccount() : balance(0.0), number(0), active(true), transCount(0) {
+    FileBankAccount() : balance(0.0), number(0), active(true), transCount(0), deleted(false) {
         std::memset(name, 0, sizeof(name));
     }
 
@@ -73,48 +87,631 @@ BankAccount toBankAccount(const FileBankAccount& fileAccount) {
     );
 }
 
-class BankAccountRepo {
+// Sorted (account number, record offset) pairs, persisted next to account.dat.
+// The sidecar holds a sorted base section followed by a log of deltas: a
+// change appends one small delta instead of rewriting the file, and the
+// deltas are merged into the base at load and whenever they outnumber it.
+// The header keeps the record and tombstone counts of account.dat the base
+// was built against; a stale index is detected and rebuilt on load.
+// A number may appear more than once; lookups use the first record.
+class AccountIndex {
 private:
-    const std::string fileName = "account.dat";
+    struct Entry {
+        int number;
+        long long offset;
+    };
+
+    struct Header {
+        long long recordCount;
+        long long deadCount;
+        long long baseEntries;
+    };
+
+    enum Op { Appended = 1, Renumbered = 2, Removed = 3 };
+
+    struct Delta {
+        int op;
+        int number;
+        int oldNumber;          // Renumbered only
+        long long offset;
+    };
+
+    const std::string fileName;
+    long long recordCount = 0;
+    long long deadCount = 0;
+    std::vector<Entry> entries;
+    std::ofstream deltaFile;
+    size_t deltaCount = 0;
+
+    std::vector<Entry>::iterator lowerBound(int number) {
+        return std::lower_bound(entries.begin(), entries.end(), number,
+            [](const Entry& entry, int num) { return entry.number < num; });
+    }
+
+    void insert(int number, long long offset) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), Entry{number, offset},
+            [](const Entry& a, const Entry& b) {
+                return a.number < b.number || (a.number == b.number && a.offset < b.offset);
+            });
+        entries.insert(it, Entry{number, offset});
+    }
+
+    // Drop the entry for `offset`, looked up under `number` first.
+    bool erase(int number, long long offset) {
+        for (auto it = lowerBound(number); it != entries.end() && it->number == number; ++it) {
+            if (it->offset == offset) {
+                entries.erase(it);
+                return true;
+            }
+        }
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->offset == offset) {
+                entries.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void replay(const Delta& delta) {
+        switch (delta.op) {
+        case Appended:
+            insert(delta.number, delta.offset);
+            recordCount++;
+            break;
+        case Renumbered:
+            erase(delta.oldNumber, delta.offset);
+            insert(delta.number, delta.offset);
+            break;
+        case Removed:
+            if (erase(delta.number, delta.offset)) {
+                deadCount++;
+            }
+            break;
+        }
+    }
+
+    void record(const Delta& delta) {
+        replay(delta);
+        if (++deltaCount > std::max<size_t>(4096, entries.size())) {
+            save();
+            return;
+        }
+        deltaFile.write(reinterpret_cast<const char*>(&delta), sizeof(Delta));
+        deltaFile.flush();
+        if (!deltaFile) {
+            throw std::runtime_error("Failed to append to index file.");
+        }
+    }
 
 public:
-    void create(const BankAccount& account) {
-        std::ofstream file(fileName, std::ios::binary | std::ios::app);
+    explicit AccountIndex(const std::string& indexFileName) : fileName(indexFileName) {}
+
+    long long records() const { return recordCount; }
+    long long dead() const { return deadCount; }
+
+    void load(const std::string& dataFileName) {
+        std::ifstream dataFile(dataFileName, std::ios::binary | std::ios::ate);
+        long long dataRecords = dataFile ? static_cast<long long>(dataFile.tellg()) / sizeof(FileBankAccount) : 0;
+
+        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+        if (file) {
+            long long fileSize = file.tellg();
+            Header header;
+            file.seekg(0, std::ios::beg);
+            if (fileSize >= static_cast<long long>(sizeof(Header))
+                    && file.read(reinterpret_cast<char*>(&header), sizeof(Header))
+                    && header.baseEntries >= 0
+                    && header.baseEntries <= static_cast<long long>((fileSize - sizeof(Header)) / sizeof(Entry))) {
+                recordCount = header.recordCount;
+                deadCount = header.deadCount;
+                entries.resize(header.baseEntries);
+                file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(Entry));
+                // a torn delta at the tail is ignored
+                Delta delta;
+                size_t deltas = 0;
+                while (file.read(reinterpret_cast<char*>(&delta), sizeof(Delta))) {
+                    replay(delta);
+                    deltas++;
+                }
+                if (recordCount == dataRecords) {
+                    if (deltas > 0) {
+                        save();
+                    } else {
+                        openDeltaFile();
+                    }
+                    return;
+                }
+            }
+        }
+        rebuild(dataFileName);
+    }
+
+    void rebuild(const std::string& dataFileName) {
+        entries.clear();
+        recordCount = 0;
+        deadCount = 0;
+
+        std::ifstream dataFile(dataFileName, std::ios::binary);
+        FileBankAccount temp;
+        while (dataFile && dataFile.read(reinterpret_cast<char*>(&temp), sizeof(FileBankAccount))) {
+            if (temp.deleted) {
+                deadCount++;
+            } else {
+                entries.push_back(Entry{temp.number, recordCount * static_cast<long long>(sizeof(FileBankAccount))});
+            }
+            recordCount++;
+        }
+        std::stable_sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.number < b.number; });
+        save();
+    }
+
+    // Merge: rewrite the base section and start an empty delta log.
+    void save() {
+        deltaFile.close();
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
         if (!file) {
-            throw std::runtime_error("Failed to open file for writing.");
+            throw std::runtime_error("Failed to open index file for writing.");
         }
+        Header header{recordCount, deadCount, static_cast<long long>(entries.size())};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+        file.close();
+        openDeltaFile();
+    }
 
-        FileBankAccount fileAccount = toFileBankAccount(account);
-        file.write(reinterpret_cast<const char*>(&fileAccount), sizeof(FileBankAccount));
+    void openDeltaFile() {
+        deltaFile.close();
+        deltaFile.clear();
+        deltaFile.open(fileName, std::ios::binary | std::ios::app);
+        if (!deltaFile) {
+            throw std::runtime_error("Failed to open index file for writing.");
+        }
+        deltaCount = 0;
+    }
+
+    bool find(int number, long long& offset) {
+        auto it = lowerBound(number);
+        if (it == entries.end() || it->number != number) {
+            return false;
+        }
+        offset = it->offset;
+        return true;
+    }
+
+    std::vector<long long> findAll(int number) {
+        std::vector<long long> offsets;
+        for (auto it = lowerBound(number); it != entries.end() && it->number == number; ++it) {
+            offsets.push_back(it->offset);
+        }
+        return offsets;
+    }
+
+    void appended(int number, long long offset) {
+        record(Delta{Appended, number, 0, offset});
+    }
+
+    void renumbered(int oldNumber, int newNumber, long long offset) {
+        record(Delta{Renumbered, newNumber, oldNumber, offset});
+    }
+
+    // The record of `number` at `offset` has been tombstoned in the data file.
+    void removed(int number, long long offset) {
+        record(Delta{Removed, number, 0, offset});
+    }
+};
+
+// Redo log for account.dat. Every change is logged as full after-images of
+// the records it touches; a change is durable once the fsync covering it
+// returns, and is then written in place through `apply`, followed by the
+// change's onApplied hook (index upkeep), all before any checkpoint.
+// Concurrent callers share fsyncs (group commit): whoever finds no flush in
+// progress becomes the leader and flushes everyone's pending entries at once.
+// The log is truncated at a checkpoint, after the data file itself is synced.
+// If writing or syncing a batch fails, the log is cut back to its last good
+// length and every change in the batch fails. If applying fails, the log is
+// kept for recovery and every later commit fails until the program restarts.
+class WriteAheadLog {
+public:
+    struct Change {
+        long long offset;
+        FileBankAccount image;
+    };
+
+private:
+    struct Entry {
+        unsigned int magic;
+        unsigned int checksum;
+        long long sequence;
+        long long offset;
+        int last;               // 1 on the final entry of a change
+        FileBankAccount image;
+    };
+    static const unsigned int entryMagic = 0x57414C31; // "WAL1"
+
+    const std::string fileName;
+    std::function<void(long long, const FileBankAccount&)> apply;
+    std::function<void()> syncData;
+    const size_t checkpointEvery;
+
+    int fd = -1;
+    off_t logLength = 0;                // bytes of complete, synced entries
+    std::mutex mtx;
+    std::condition_variable flushed;
+    std::vector<Entry> pending;
+    std::vector<std::function<void()>> pendingHooks;
+    long long nextSequence = 1;
+    long long resolvedSequence = 0;     // every change up to here is durable or failed
+    std::vector<std::pair<long long, long long>> failedRanges;
+    size_t sinceCheckpoint = 0;
+    bool flushing = false;
+    std::atomic<bool> broken{false};
+
+    static unsigned int checksumOf(const Entry& entry) {
+        // FNV-1a over everything after the checksum field
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&entry.sequence);
+        size_t length = sizeof(Entry) - offsetof(Entry, sequence);
+        unsigned int hash = 2166136261u;
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    void writeAll(const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0) {
+                throw std::runtime_error("Failed to write to log file.");
+            }
+            data += written;
+            length -= written;
+        }
+    }
+
+    // Caller is the leader: log, fsync, apply in sequence order, run hooks.
+    void flush(const std::vector<Entry>& batch, const std::vector<std::function<void()>>& hooks) {
+        size_t length = batch.size() * sizeof(Entry);
+        try {
+            writeAll(reinterpret_cast<const char*>(batch.data()), length);
+            if (::fdatasync(fd) != 0) {
+                throw std::runtime_error("Failed to sync log file.");
+            }
+        } catch (...) {
+            // drop a torn entry, or recovery would stop at it
+            if (::ftruncate(fd, logLength) != 0) {
+                broken = true;
+            }
+            throw;
+        }
+        logLength += length;
+
+        try {
+            for (const Entry& entry : batch) {
+                apply(entry.offset, entry.image);
+            }
+            for (const auto& hook : hooks) {
+                if (hook) {
+                    hook();
+                }
+            }
+            sinceCheckpoint += batch.size();
+            if (sinceCheckpoint >= checkpointEvery) {
+                checkpointLocked();
+            }
+        } catch (...) {
+            broken = true;
+            throw;
+        }
+    }
+
+    void checkpointLocked() {
+        syncData();
+        if (::ftruncate(fd, 0) != 0) {
+            throw std::runtime_error("Failed to truncate log file.");
+        }
+        logLength = 0;
+        sinceCheckpoint = 0;
+    }
+
+    bool failed(long long sequence) const {
+        for (const auto& range : failedRanges) {
+            if (sequence >= range.first && sequence <= range.second) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    WriteAheadLog(const std::string& logFileName,
+                  std::function<void(long long, const FileBankAccount&)> applyChange,
+                  std::function<void()> syncDataFile,
+                  size_t checkpointEveryEntries = 4096)
+        : fileName(logFileName), apply(applyChange), syncData(syncDataFile),
+          checkpointEvery(checkpointEveryEntries) {
+        fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open log file.");
+        }
+        logLength = ::lseek(fd, 0, SEEK_END);
+    }
+
+    ~WriteAheadLog() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Re-apply every complete change left by a crash, then checkpoint.
+    // A torn or half-logged change at the tail is dropped.
+    size_t recover() {
+        std::ifstream file(fileName, std::ios::binary);
+        std::vector<Entry> change;
+        Entry entry;
+        size_t replayed = 0;
+
+        while (file.read(reinterpret_cast<char*>(&entry), sizeof(Entry))) {
+            if (entry.magic != entryMagic || entry.checksum != checksumOf(entry)) {
+                break;
+            }
+            change.push_back(entry);
+            if (entry.last == 1) {
+                for (const Entry& logged : change) {
+                    apply(logged.offset, logged.image);
+                }
+                replayed += change.size();
+                change.clear();
+            }
+        }
         file.close();
+
+        std::lock_guard<std::mutex> lock(mtx);
+        checkpointLocked();
+        return replayed;
     }
 
-    void update(int id, const BankAccount& account) {
-        std::fstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
-        if (!file) {
+    // Blocks until the whole change is durable and applied, and onApplied
+    // has run; throws if the change did not make it.
+    void commit(const std::vector<Change>& changes, std::function<void()> onApplied = nullptr) {
+        if (changes.empty()) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mtx);
+        if (broken) {
+            throw std::runtime_error("Log is unusable after a failed write; restart to recover.");
+        }
+        long long sequence = 0;
+        for (size_t i = 0; i < changes.size(); i++) {
+            Entry entry;
+            std::memset(static_cast<void*>(&entry), 0, sizeof(Entry));
+            entry.magic = entryMagic;
+            entry.sequence = sequence = nextSequence++;
+            entry.offset = changes[i].offset;
+            entry.last = (i + 1 == changes.size()) ? 1 : 0;
+            entry.image = changes[i].image;
+            pending.push_back(entry);
+            pending.back().checksum = checksumOf(pending.back());
+        }
+        pendingHooks.push_back(std::move(onApplied));
+
+        while (resolvedSequence < sequence) {
+            if (flushing || pending.empty()) {
+                flushed.wait(lock);
+                continue;
+            }
+            std::vector<Entry> batch;
+            std::vector<std::function<void()>> hooks;
+            batch.swap(pending);
+            hooks.swap(pendingHooks);
+            if (broken) {
+                failedRanges.emplace_back(batch.front().sequence, batch.back().sequence);
+                resolvedSequence = batch.back().sequence;
+                flushed.notify_all();
+                continue;
+            }
+
+            flushing = true;
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                flush(batch, hooks);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            flushing = false;
+            if (error) {
+                failedRanges.emplace_back(batch.front().sequence, batch.back().sequence);
+            }
+            resolvedSequence = batch.back().sequence;
+            flushed.notify_all();
+            if (error && failed(sequence)) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        if (failed(sequence)) {
+            throw std::runtime_error("Change was not committed: the log flush failed.");
+        }
+    }
+
+    void checkpoint() {
+        std::unique_lock<std::mutex> lock(mtx);
+        flushed.wait(lock, [this]() { return !flushing; });
+        checkpointLocked();
+    }
+};
+
+class BankAccountRepo {
+private:
+    const std::string fileName = "account.dat";
+    AccountIndex index{"account.idx"};
+    std::mutex indexMtx;                 // index is read by callers and changed by the log leader
+    std::mutex createMtx;                // creates take the next offset one at a time
+    // Offsets and dataFd stay valid while layoutMtx is held shared: create,
+    // update and reads hold it from lookup through commit. Deletes and
+    // compaction hold it exclusively, so no commit is in flight meanwhile.
+    // layoutTurnMtx keeps a waiting exclusive holder from being starved by
+    // a steady stream of shared ones.
+    std::shared_mutex layoutMtx;
+    std::mutex layoutTurnMtx;
+    const int compactDeadPercent = 25;   // compact once this share of records is deleted
+    int dataFd = -1;
+    WriteAheadLog wal{"account.wal",
+        [this](long long offset, const FileBankAccount& image) { writeRecord(offset, image); },
+        [this]() { syncDataFile(); }};
+
+    void openDataFile() {
+        dataFd = ::open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+        if (dataFd < 0) {
             throw std::runtime_error("Failed to open file for updating.");
         }
+    }
 
-        FileBankAccount fileAccount = toFileBankAccount(account);
+    void writeRecord(long long offset, const FileBankAccount& image) {
+        if (::pwrite(dataFd, &image, sizeof(FileBankAccount), offset) != static_cast<ssize_t>(sizeof(FileBankAccount))) {
+            throw std::runtime_error("Failed to write account record.");
+        }
+    }
+
+    FileBankAccount readRecord(long long offset) {
         FileBankAccount temp;
-        bool updated = false;
+        if (::pread(dataFd, &temp, sizeof(FileBankAccount), offset) != static_cast<ssize_t>(sizeof(FileBankAccount))) {
+            throw std::runtime_error("Failed to read account record.");
+        }
+        return temp;
+    }
 
-        while (file.read(reinterpret_cast<char*>(&temp), sizeof(FileBankAccount))) {
-            if (temp.number == id) {
-                file.seekp(-static_cast<int>(sizeof(FileBankAccount)), std::ios::cur);
-                file.write(reinterpret_cast<const char*>(&fileAccount), sizeof(FileBankAccount));
-                updated = true;
-                break;
+    void syncDataFile() {
+        if (::fsync(dataFd) != 0) {
+            throw std::runtime_error("Failed to sync data file.");
+        }
+    }
+
+    std::shared_lock<std::shared_mutex> shareLayout() {
+        std::lock_guard<std::mutex> turn(layoutTurnMtx);
+        return std::shared_lock<std::shared_mutex>(layoutMtx);
+    }
+
+    std::unique_lock<std::shared_mutex> ownLayout() {
+        std::lock_guard<std::mutex> turn(layoutTurnMtx);
+        return std::unique_lock<std::shared_mutex>(layoutMtx);
+    }
+
+public:
+    // A replayed log may hold changes the index never saw: rebuild it then.
+    BankAccountRepo() {
+        openDataFile();
+        if (wal.recover() > 0) {
+            index.rebuild(fileName);
+        } else {
+            index.load(fileName);
+        }
+    }
+
+    ~BankAccountRepo() {
+        try {
+            wal.checkpoint();
+        } catch (const std::exception& e) {
+            // the log is kept, so the next start replays it
+            std::cerr << "Checkpoint at close failed: " << e.what() << std::endl;
+        }
+        ::close(dataFd);
+    }
+
+    void create(const BankAccount& account) {
+        auto layout = shareLayout();
+        std::lock_guard<std::mutex> createLock(createMtx);
+        FileBankAccount fileAccount = toFileBankAccount(account);
+        long long offset;
+        {
+            std::lock_guard<std::mutex> lock(indexMtx);
+            offset = index.records() * sizeof(FileBankAccount);
+        }
+        int number = fileAccount.number;
+        wal.commit({{offset, fileAccount}}, [this, number, offset]() {
+            std::lock_guard<std::mutex> lock(indexMtx);
+            index.appended(number, offset);
+        });
+    }
+
+    // Durable when it returns; concurrent updates share one log fsync.
+    void update(int id, const BankAccount& account) {
+        auto layout = shareLayout();
+        long long offset;
+        {
+            std::lock_guard<std::mutex> lock(indexMtx);
+            if (!index.find(id, offset)) {
+                throw std::runtime_error("Account with given ID not found.");
             }
         }
 
-        file.close();
-        if (!updated) {
-            throw std::runtime_error("Account with given ID not found.");
+        FileBankAccount fileAccount = toFileBankAccount(account);
+        std::function<void()> onApplied;
+        if (fileAccount.number != id) {
+            int number = fileAccount.number;
+            onApplied = [this, id, number, offset]() {
+                std::lock_guard<std::mutex> lock(indexMtx);
+                index.renumbered(id, number, offset);
+            };
         }
+        wal.commit({{offset, fileAccount}}, onApplied);
     }
 
+    // Runs alone, so the tombstones are built from the current records.
     void deleteById(int id) {
+        auto layout = ownLayout();
+        std::vector<long long> offsets;
+        {
+            std::lock_guard<std::mutex> lock(indexMtx);
+            offsets = index.findAll(id);
+        }
+        if (offsets.empty()) {
+            throw std::runtime_error("Account with given ID not found.");
+        }
+
+        // All tombstones go into one logged change, so recovery applies all or none.
+        std::vector<WriteAheadLog::Change> changes;
+        for (long long offset : offsets) {
+            FileBankAccount temp = readRecord(offset);
+            temp.deleted = true;
+            changes.push_back({offset, temp});
+        }
+        wal.commit(changes, [this, id, offsets]() {
+            std::lock_guard<std::mutex> lock(indexMtx);
+            for (long long offset : offsets) {
+                index.removed(id, offset);
+            }
+        });
+
+        bool compactNow;
+        {
+            std::lock_guard<std::mutex> lock(indexMtx);
+            compactNow = index.dead() * 100 >= index.records() * compactDeadPercent;
+        }
+        if (compactNow) {
+            compactLocked();
+        }
+    }
+
+    void compact() {
+        auto layout = ownLayout();
+        compactLocked();
+    }
+
+private:
+    // Rewrite account.dat without tombstones. Offsets change, so the log is
+    // checkpointed first, and temp.dat replaces account.dat in one rename.
+    // Caller holds layoutMtx exclusively.
+    void compactLocked() {
+        wal.checkpoint();
+
         std::ifstream file(fileName, std::ios::binary);
         if (!file) {
             throw std::runtime_error("Failed to open file for reading.");
@@ -126,28 +723,34 @@ public:
         }
 
         FileBankAccount temp;
-        bool found = false;
 
         while (file.read(reinterpret_cast<char*>(&temp), sizeof(FileBankAccount))) {
-            if (temp.number != id) {
+            if (!temp.deleted) {
                 tempFile.write(reinterpret_cast<const char*>(&temp), sizeof(FileBankAccount));
-            } else {
-                found = true;
             }
         }
 
         file.close();
         tempFile.close();
 
-        if (!found) {
-            throw std::runtime_error("Account with given ID not found.");
+        int tempFd = ::open("temp.dat", O_RDONLY);
+        if (tempFd < 0 || ::fsync(tempFd) != 0) {
+            throw std::runtime_error("Failed to sync temporary file.");
         }
+        ::close(tempFd);
 
-        std::remove(fileName.c_str());
-        std::rename("temp.dat", fileName.c_str());
+        if (std::rename("temp.dat", fileName.c_str()) != 0) {
+            throw std::runtime_error("Failed to replace data file.");
+        }
+        ::close(dataFd);
+        openDataFile();
+        std::lock_guard<std::mutex> lock(indexMtx);
+        index.rebuild(fileName);
     }
 
+public:
     std::vector<BankAccount> readAll() {
+        auto layout = shareLayout();
         std::ifstream file(fileName, std::ios::binary);
         if (!file) {
             throw std::runtime_error("Failed to open file for reading.");
@@ -157,7 +760,9 @@ public:
         FileBankAccount temp;
 
         while (file.read(reinterpret_cast<char*>(&temp), sizeof(FileBankAccount))) {
-            accounts.push_back(toBankAccount(temp));
+            if (!temp.deleted) {
+                accounts.push_back(toBankAccount(temp));
+            }
         }
 
         file.close();
@@ -165,22 +770,20 @@ public:
     }
 
     BankAccount readById(int id) {
-        std::ifstream file(fileName, std::ios::binary);
-        if (!file) {
-            throw std::runtime_error("Failed to open file for reading.");
-        }
-
-        FileBankAccount temp;
-
-        while (file.read(reinterpret_cast<char*>(&temp), sizeof(FileBankAccount))) {
-            if (temp.number == id) {
-                file.close();
-                return toBankAccount(temp);
+        auto layout = shareLayout();
+        long long offset;
+        {
+            std::lock_guard<std::mutex> lock(indexMtx);
+            if (!index.find(id, offset)) {
+                throw std::runtime_error("Account with given ID not found.");
             }
         }
 
-        file.close();
-        throw std::runtime_error("Account with given ID not found.");
+        FileBankAccount temp = readRecord(offset);
+        if (temp.deleted || temp.number != id) {
+            throw std::runtime_error("Account with given ID not found.");
+        }
+        return toBankAccount(temp);
     }
 };
 
@@ -227,5 +830,24 @@ int main() {
                   << ", Transactions: " << acc.getTransCount() << std::endl;
     }
 
+    // Concurrent durable updates: threads waiting on the log share its fsyncs
+    const int threadCount = 8;
+    const int updatesPerThread = 200;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&repo, t]() {
+            for (int i = 1; i <= updatesPerThread; i++) {
+                repo.update(3, BankAccount(7000 + i, 3, "Charlie", false, i));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\n" << threadCount * updatesPerThread << " durable updates in " << seconds << " s ("
+              << static_cast<long long>(threadCount * updatesPerThread / seconds) << " updates/s)" << std::endl;
+
     return 0;
 }
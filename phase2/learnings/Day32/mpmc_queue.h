@@ -0,0 +1,146 @@
+#pragma once
+// Bounded multi-producer multi-consumer queue (Dmitry Vyukov's design).
+// Every slot carries a sequence number that says whose turn it is:
+//     sequence == pos        free, the producer claiming pos may write it
+//     sequence == pos + 1    full, the consumer claiming pos may read it
+// Producers claim positions with a CAS on enqueuePos and consumers on
+// dequeuePos; those two counters live on separate cache lines, and a
+// producer and a consumer only meet on the slot they hand over.
+// TryPush/TryPop never block. Push/Pop spin a little, then sleep on a
+// condition variable that is only signalled (notify_one, one thread)
+// when somebody is actually sleeping on that side.
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+template<class T>
+class BoundedMpmcQueue {
+    private:
+        struct alignas(64) Slot {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        static const int SPIN_LIMIT = 100;
+
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;
+        alignas(64) std::atomic<size_t> enqueuePos { 0 };
+        alignas(64) std::atomic<size_t> dequeuePos { 0 };
+
+        alignas(64) std::atomic<int> pushWaiters { 0 };
+        std::mutex pushMtx;
+        std::condition_variable notFull;
+        alignas(64) std::atomic<int> popWaiters { 0 };
+        std::mutex popMtx;
+        std::condition_variable notEmpty;
+
+        // Called after a push (pop) succeeded: wake one sleeping consumer
+        // (producer), if there is one. The fence pairs with the one in
+        // Sleep_: either we see the waiter or the waiter sees our change.
+        static void Wake_(std::atomic<int>& waiters, std::mutex& mtx, std::condition_variable& cv) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) > 0) {
+                std::lock_guard<std::mutex> lock(mtx);
+                cv.notify_one();
+            }
+        }
+
+        template<class Attempt>
+        static void Sleep_(std::atomic<int>& waiters, std::mutex& mtx, std::condition_variable& cv, Attempt attempt) {
+            for (int spin = 0; spin < SPIN_LIMIT; spin++) {
+                if (attempt()) {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+            std::unique_lock<std::mutex> lock(mtx);
+            waiters++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv.wait(lock, attempt);
+            waiters--;
+        }
+    public:
+        // capacity is rounded up to a power of two
+        explicit BoundedMpmcQueue(size_t capacity) {
+            size_t size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            slots.reset(new Slot[size]);
+            mask = size - 1;
+            for (size_t i = 0; i < size; i++) {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+        BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+        size_t Capacity() const { return mask + 1; }
+
+        // false, leaving value untouched, when the queue is full
+        bool TryPush(T& value) {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = slots[pos & mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.value = std::move(value);
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;   // the slot still holds last round's value
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // false when the queue is empty
+        bool TryPop(T& value) {
+            size_t pos = dequeuePos.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = slots[pos & mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = std::move(slot.value);
+                        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;   // nothing published at pos yet
+                } else {
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Blocks while the queue is full.
+        void Push(T value) {
+            if (!TryPush(value)) {
+                Sleep_(pushWaiters, pushMtx, notFull, [&] { return TryPush(value); });
+            }
+            Wake_(popWaiters, popMtx, notEmpty);
+        }
+
+        // Blocks while the queue is empty.
+        T Pop() {
+            T value;
+            if (!TryPop(value)) {
+                Sleep_(popWaiters, popMtx, notEmpty, [&] { return TryPop(value); });
+            }
+            Wake_(pushWaiters, pushMtx, notFull);
+            return value;
+        }
+};
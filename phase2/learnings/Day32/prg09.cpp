@@ -0,0 +1,95 @@
+// producer - consumer problem, benchmarked
+// the mutex + condition_variable buffer of prg07/prg08 (notify_all on every
+// push and pop) against the lock-free BoundedMpmcQueue, same capacity,
+// half the threads producing and half consuming
+
+#include<iostream>
+#include<queue>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<chrono>
+#include<condition_variable>
+
+#include "mpmc_queue.h"
+
+const long ITEMS = 1L << 21;    // per run, over all producers
+const size_t CAPACITY = 1024;
+
+// prg07's buffer, wrapped so both designs run the same benchmark
+class MutexQueue {
+    private:
+        size_t maxSize;
+        std::queue<long> products;
+        std::mutex mt;
+        std::condition_variable cv;
+    public:
+        explicit MutexQueue(size_t maxSize) : maxSize(maxSize) {}
+
+        void Push(long product_id) {
+            std::unique_lock<std::mutex> lock(mt);
+            cv.wait(lock, [this] { return products.size() < maxSize; });
+            products.push(product_id);
+            cv.notify_all();
+        }
+
+        long Pop() {
+            std::unique_lock<std::mutex> lock(mt);
+            cv.wait(lock, [this] { return !products.empty(); });
+            long product_id = products.front();
+            products.pop();
+            cv.notify_all();
+            return product_id;
+        }
+};
+
+// ops/sec (one push + one pop = 2 ops) with `threads` threads
+template<class Queue>
+double run(int threads) {
+    Queue queue(CAPACITY);
+    int producers = threads / 2;
+    int consumers = threads - producers;
+    std::vector<long> sums(consumers);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < producers; p++) {
+        workers.emplace_back([&queue, p, producers] {
+            for (long id = p; id < ITEMS; id += producers) {
+                queue.Push(id);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        workers.emplace_back([&queue, &sums, c, consumers] {
+            long share = ITEMS / consumers + (c < ITEMS % consumers ? 1 : 0);
+            for (long n = 0; n < share; n++) {
+                sums[c] += queue.Pop();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long total = 0;
+    for (long sum : sums) {
+        total += sum;
+    }
+    if (total != ITEMS * (ITEMS - 1) / 2) {
+        std::cout << "LOST OR DUPLICATED PRODUCTS" << std::endl;
+    }
+    return 2 * ITEMS / seconds;
+}
+
+int main() {
+    std::cout << "threads\tmutex+cv ops/s\tlock-free ops/s" << std::endl;
+    for (int threads : { 2, 4, 8, 16, 32, 64 }) {
+        double locked = run<MutexQueue>(threads);
+        double lockFree = run<BoundedMpmcQueue<long>>(threads);
+        std::cout << threads << "\t" << (long)locked << "\t" << (long)lockFree
+                  << "\t(x" << lockFree / locked << ")" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+// BankAccount grown into a ledger of many accounts shared by many threads.
+// Every balance is its own atomic: deposits are a fetch_add and
+// withdrawals a compare-exchange loop that refuses to overdraw, so
+// single-account operations take no lock at all. A transfer must move
+// money out of one account and into another as one step, so it locks the
+// stripes of both accounts, always lower stripe first (no deadlock), and
+// Total() locks every stripe, so it never sees a transfer half done.
+// Different stripes lock independently: there is no global lock.
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+class BankLedger {
+    private:
+        struct alignas(64) Stripe {
+            std::mutex mtx;
+        };
+
+        static const size_t STRIPES = 1024;
+
+        size_t size;
+        std::unique_ptr<std::atomic<long long>[]> balances;
+        std::unique_ptr<Stripe[]> stripes;
+
+        // balance -= amount unless that would go below zero
+        bool Take_(size_t account, long long amount) {
+            std::atomic<long long>& balance = balances[account];
+            long long current = balance.load(std::memory_order_relaxed);
+            do {
+                if (current < amount) {
+                    return false;
+                }
+            } while (!balance.compare_exchange_weak(current, current - amount, std::memory_order_relaxed));
+            return true;
+        }
+    public:
+        BankLedger(size_t accounts, long long openingBalance = 0)
+            : size(accounts), balances(new std::atomic<long long>[accounts]), stripes(new Stripe[STRIPES]) {
+            for (size_t i = 0; i < size; i++) {
+                balances[i].store(openingBalance, std::memory_order_relaxed);
+            }
+        }
+
+        BankLedger(const BankLedger&) = delete;
+        BankLedger& operator=(const BankLedger&) = delete;
+
+        size_t Size() const { return size; }
+
+        void Deposit(size_t account, long long amount) {
+            balances[account].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        // false, and nothing withdrawn, if the balance is short
+        bool Withdraw(size_t account, long long amount) {
+            return Take_(account, amount);
+        }
+
+        // false, and nothing moved, if from's balance is short
+        bool Transfer(size_t from, size_t to, long long amount) {
+            size_t first = from % STRIPES, second = to % STRIPES;
+            if (first > second) {
+                std::swap(first, second);
+            }
+            std::lock_guard<std::mutex> lockFirst(stripes[first].mtx);
+            std::unique_lock<std::mutex> lockSecond;
+            if (second != first) {
+                lockSecond = std::unique_lock<std::mutex>(stripes[second].mtx);
+            }
+            // still a CAS: lock-free withdrawals do not take the stripe
+            if (!Take_(from, amount)) {
+                return false;
+            }
+            balances[to].fetch_add(amount, std::memory_order_relaxed);
+            return true;
+        }
+
+        long long GetBalance(size_t account) const {
+            return balances[account].load(std::memory_order_relaxed);
+        }
+
+        // Sum of all balances, with no transfer in flight.
+        long long Total() {
+            for (size_t i = 0; i < STRIPES; i++) {
+                stripes[i].mtx.lock();
+            }
+            long long total = 0;
+            for (size_t i = 0; i < size; i++) {
+                total += balances[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = STRIPES; i-- > 0;) {
+                stripes[i].mtx.unlock();
+            }
+            return total;
+        }
+};
@@ -0,0 +1,281 @@
+#pragma once
+// A small future/promise with continuations, running on the shared
+// WorkStealingPool. Instead of blocking a thread in get() for every
+// pending result, work is chained:
+//     my::async(f, args...)   f(args...) on the pool
+//     fut.then(g)             g(value) on the pool once fut is ready
+//     my::when_all(futs)      ready when all are, with all the values
+//     my::when_any(futs)      ready when the first one is, with its index
+// An exception thrown by a task travels down the chain and is rethrown
+// by get(). Futures are shared handles (like std::shared_future): copies
+// refer to the same result. Values must be copyable; T cannot be void.
+// Errors of the future itself are std::future_error, as in the standard:
+// no_state for a default-constructed future, broken_promise when every
+// copy of its promise is destroyed without setting it.
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "work_stealing_pool.h"
+
+namespace my {
+
+template<class T> class future;
+template<class T> class promise;
+
+namespace detail {
+
+    template<class T>
+    struct SharedState {
+        std::mutex mtx;
+        std::condition_variable readyCv;
+        bool ready = false;
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::vector<std::function<void()>> callbacks;    // run once ready
+
+        // Runs callback when the state is ready: right away if it already is.
+        void OnReady(std::function<void()> callback) {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!ready) {
+                    callbacks.push_back(std::move(callback));
+                    return;
+                }
+            }
+            callback();
+        }
+
+        template<class Set>
+        void Complete(Set set) {
+            std::vector<std::function<void()>> pending;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (ready) {
+                    throw std::future_error(std::future_errc::promise_already_satisfied);
+                }
+                set();
+                ready = true;
+                pending.swap(callbacks);
+            }
+            readyCv.notify_all();
+            for (auto& callback : pending) {
+                callback();
+            }
+        }
+
+        // No promise is left to set the state: fail it rather than leave
+        // waiters and continuations hanging.
+        void Abandon() {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (ready) {
+                    return;
+                }
+            }
+            Complete([this] {
+                error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            });
+        }
+    };
+
+    // Shared by all copies of one promise; the last copy to go abandons
+    // the state. Futures hold the state only, so they do not keep it alive.
+    template<class T>
+    struct PromiseOwner {
+        std::shared_ptr<SharedState<T>> state = std::make_shared<SharedState<T>>();
+
+        ~PromiseOwner() {
+            state->Abandon();
+        }
+    };
+
+} // namespace detail
+
+template<class T>
+class future {
+    static_assert(!std::is_void<T>::value, "future<void> is not supported");
+    private:
+        std::shared_ptr<detail::SharedState<T>> state;
+
+        explicit future(std::shared_ptr<detail::SharedState<T>> state) : state(std::move(state)) {}
+
+        void CheckState_() const {
+            if (!valid()) {
+                throw std::future_error(std::future_errc::no_state);
+            }
+        }
+
+        friend class promise<T>;
+        template<class U> friend class future;
+        template<class U> friend future<std::vector<U>> when_all(const std::vector<future<U>>&);
+        template<class U> friend future<std::pair<size_t, U>> when_any(const std::vector<future<U>>&);
+    public:
+        future() = default;
+
+        bool valid() const { return state != nullptr; }
+
+        bool is_ready() const {
+            CheckState_();
+            std::lock_guard<std::mutex> lock(state->mtx);
+            return state->ready;
+        }
+
+        // Waits for the value, running queued pool tasks meanwhile, so a
+        // pool worker waiting here does not starve the pool. Nothing signals
+        // a newly queued task, so an idle wait is short and then looks again.
+        void wait() const {
+            WorkStealingPool& pool = WorkStealingPool::Instance();
+            while (!is_ready()) {
+                if (!pool.RunPendingTask()) {
+                    std::unique_lock<std::mutex> lock(state->mtx);
+                    state->readyCv.wait_for(lock, std::chrono::milliseconds(1), [this] { return state->ready; });
+                }
+            }
+        }
+
+        // The value, or the task's exception rethrown.
+        T get() const {
+            wait();
+            if (state->error) {
+                std::rethrow_exception(state->error);
+            }
+            return *state->value;
+        }
+
+        // then(f) -> future of f(value); f runs on the pool once this is
+        // ready. If this future failed, f is skipped and so is the error.
+        template<class F>
+        future<std::invoke_result_t<F, const T&>> then(F f) const {
+            CheckState_();
+            using R = std::invoke_result_t<F, const T&>;
+            promise<R> next;
+            future<R> result = next.get_future();
+            auto source = state;
+            state->OnReady([source, f, next]() mutable {
+                WorkStealingPool::Instance().Submit([source, f, next]() mutable {
+                    if (source->error) {
+                        next.set_exception(source->error);
+                        return;
+                    }
+                    try {
+                        next.set_value(f(*source->value));
+                    } catch (...) {
+                        next.set_exception(std::current_exception());
+                    }
+                });
+            });
+            return result;
+        }
+};
+
+// Setting the value (or exception) is allowed once; copies of a promise
+// share the state, so it can be captured in copyable tasks. If the last
+// copy is destroyed first, the future fails with broken_promise.
+template<class T>
+class promise {
+    private:
+        std::shared_ptr<detail::PromiseOwner<T>> owner = std::make_shared<detail::PromiseOwner<T>>();
+    public:
+        future<T> get_future() const { return future<T>(owner->state); }
+
+        void set_value(T value) {
+            detail::SharedState<T>& state = *owner->state;
+            state.Complete([&] { state.value.emplace(std::move(value)); });
+        }
+
+        void set_exception(std::exception_ptr error) {
+            detail::SharedState<T>& state = *owner->state;
+            state.Complete([&] { state.error = error; });
+        }
+};
+
+// f(args...) on the shared pool.
+template<class F, class... Args>
+future<std::invoke_result_t<F, Args...>> async(F f, Args... args) {
+    using R = std::invoke_result_t<F, Args...>;
+    promise<R> result;
+    WorkStealingPool::Instance().Submit([result, f, args...]() mutable {
+        try {
+            result.set_value(f(args...));
+        } catch (...) {
+            result.set_exception(std::current_exception());
+        }
+    });
+    return result.get_future();
+}
+
+// Ready when every future is, with their values in order; if any failed,
+// fails with the error of the first failed future in input order (not the
+// first to fail in time). No thread waits in the meantime: the last
+// future to finish completes the result.
+template<class T>
+future<std::vector<T>> when_all(const std::vector<future<T>>& futures) {
+    promise<std::vector<T>> result;
+    if (futures.empty()) {
+        result.set_value({});
+        return result.get_future();
+    }
+    auto remaining = std::make_shared<std::atomic<size_t>>(futures.size());
+    auto states = std::make_shared<std::vector<std::shared_ptr<detail::SharedState<T>>>>();
+    for (const future<T>& each : futures) {
+        each.CheckState_();
+        states->push_back(each.state);
+    }
+    for (auto& state : *states) {
+        state->OnReady([remaining, states, result]() mutable {
+            if (--*remaining > 0) {
+                return;
+            }
+            std::vector<T> values;
+            for (auto& done : *states) {
+                if (done->error) {
+                    result.set_exception(done->error);
+                    return;
+                }
+                values.push_back(*done->value);
+            }
+            result.set_value(std::move(values));
+        });
+    }
+    return result.get_future();
+}
+
+// Ready as soon as the first future is: (its index, its value), or its
+// error. The others keep running; their results are dropped.
+template<class T>
+future<std::pair<size_t, T>> when_any(const std::vector<future<T>>& futures) {
+    if (futures.empty()) {
+        throw std::invalid_argument("when_any of no futures");
+    }
+    promise<std::pair<size_t, T>> result;
+    auto claimed = std::make_shared<std::atomic<bool>>(false);
+    for (size_t i = 0; i < futures.size(); i++) {
+        futures[i].CheckState_();
+        auto state = futures[i].state;
+        state->OnReady([claimed, state, result, i]() mutable {
+            if (claimed->exchange(true)) {
+                return;
+            }
+            if (state->error) {
+                result.set_exception(state->error);
+            } else {
+                result.set_value(std::make_pair(i, *state->value));
+            }
+        });
+    }
+    return result.get_future();
+}
+
+} // namespace my
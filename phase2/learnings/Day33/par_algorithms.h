@@ -0,0 +1,208 @@
+#pragma once
+// findSum's MyExecPolicy pattern grown into a few general algorithms.
+// Every algorithm takes an iterator range plus a policy (Seq by default);
+// under Par the range is cut into chunks that run on the shared
+// WorkStealingPool and the per-chunk results are combined in order, so
+// the operations only need to be associative, not commutative.
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <vector>
+#include <unistd.h>
+
+#include "work_stealing_pool.h"
+
+namespace my {
+
+namespace detail {
+
+    const long MIN_GRAIN = 4096;            // below this a task costs more than it saves
+    const long CHUNKS_PER_WORKER = 4;       // spare chunks for idle workers to steal
+
+    // Half the per-core L2 cache, so a chunk streams through a core without
+    // evicting itself, and a chunk's results stay warm for a following pass.
+    inline long cacheBytes() {
+        static const long bytes = [] {
+            long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+            return (l2 > 0 ? l2 : 256 * 1024) / 2;
+        }();
+        return bytes;
+    }
+
+    // Chunk boundaries [b0=first, b1, ..., bn=last] for a Par run over
+    // elements of elementSize bytes: enough chunks to keep every worker
+    // busy, none bigger than the cache budget, none smaller than MIN_GRAIN.
+    template<class It>
+    std::vector<It> chunkBounds(It first, It last, size_t elementSize) {
+        long distance = std::distance(first, last);
+        long workers = WorkStealingPool::Instance().Size();
+        long grain = distance / (CHUNKS_PER_WORKER * workers);
+        grain = std::min(grain, cacheBytes() / (long)elementSize);
+        grain = std::max(grain, MIN_GRAIN);
+
+        std::vector<It> bounds { first };
+        for (long done = grain; done < distance; done += grain) {
+            bounds.push_back(std::next(bounds.back(), grain));
+        }
+        bounds.push_back(last);
+        return bounds;
+    }
+
+    template<class It>
+    void forEachChunk(const std::vector<It>& bounds, const std::function<void(size_t)>& body) {
+        WorkStealingPool::Instance().ParallelFor(bounds.size() - 1, body);
+    }
+
+    template<class It>
+    using value_t = typename std::iterator_traits<It>::value_type;
+
+} // namespace detail
+
+template<class InputIt, class T, class BinaryOp, class UnaryOp>
+T transform_reduce(InputIt first, InputIt last, T init, BinaryOp reduce, UnaryOp transform,
+                   MyExecPolicy policy = MyExecPolicy::Seq) {
+    auto saReduce = [&](InputIt first, InputIt last, T init) -> T {
+        for (auto it = first; it != last; ++it) {
+            init = reduce(init, transform(*it));
+        }
+        return init;
+    };
+    if (policy == MyExecPolicy::Seq || first == last) {
+        return saReduce(first, last, init);
+    }
+    auto bounds = detail::chunkBounds(first, last, sizeof(detail::value_t<InputIt>));
+    std::vector<T> results(bounds.size() - 1, init);
+    detail::forEachChunk(bounds, [&](size_t i) {
+        // a chunk starts from its own first element: no identity value needed
+        results[i] = saReduce(std::next(bounds[i]), bounds[i + 1], transform(*bounds[i]));
+    });
+    for (const T& result : results) {
+        init = reduce(init, result);
+    }
+    return init;
+}
+
+template<class InputIt, class T, class BinaryOp>
+T reduce(InputIt first, InputIt last, T init, BinaryOp op, MyExecPolicy policy = MyExecPolicy::Seq) {
+    return my::transform_reduce(first, last, init, op, [](const auto& value) { return value; }, policy);
+}
+
+template<class InputIt, class T>
+T reduce(InputIt first, InputIt last, T init, MyExecPolicy policy = MyExecPolicy::Seq) {
+    return my::reduce(first, last, init, std::plus<>(), policy);
+}
+
+template<class InputIt, class UnaryPred>
+typename std::iterator_traits<InputIt>::difference_type
+count_if(InputIt first, InputIt last, UnaryPred pred, MyExecPolicy policy = MyExecPolicy::Seq) {
+    using count_t = typename std::iterator_traits<InputIt>::difference_type;
+    return my::transform_reduce(first, last, count_t(0), std::plus<>(),
+        [&](const auto& value) { return pred(value) ? count_t(1) : count_t(0); }, policy);
+}
+
+// First smallest element, as std::min_element.
+template<class ForwardIt, class Compare = std::less<>>
+ForwardIt min_element(ForwardIt first, ForwardIt last, Compare comp = Compare(),
+                      MyExecPolicy policy = MyExecPolicy::Seq) {
+    if (policy == MyExecPolicy::Seq || first == last) {
+        return std::min_element(first, last, comp);
+    }
+    auto bounds = detail::chunkBounds(first, last, sizeof(detail::value_t<ForwardIt>));
+    std::vector<ForwardIt> results(bounds.size() - 1);
+    detail::forEachChunk(bounds, [&](size_t i) {
+        results[i] = std::min_element(bounds[i], bounds[i + 1], comp);
+    });
+    ForwardIt best = results[0];
+    for (ForwardIt candidate : results) {
+        if (comp(*candidate, *best)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// First largest element, as std::max_element.
+template<class ForwardIt, class Compare = std::less<>>
+ForwardIt max_element(ForwardIt first, ForwardIt last, Compare comp = Compare(),
+                      MyExecPolicy policy = MyExecPolicy::Seq) {
+    if (policy == MyExecPolicy::Seq || first == last) {
+        return std::max_element(first, last, comp);
+    }
+    auto bounds = detail::chunkBounds(first, last, sizeof(detail::value_t<ForwardIt>));
+    std::vector<ForwardIt> results(bounds.size() - 1);
+    detail::forEachChunk(bounds, [&](size_t i) {
+        results[i] = std::max_element(bounds[i], bounds[i + 1], comp);
+    });
+    ForwardIt best = results[0];
+    for (ForwardIt candidate : results) {
+        if (comp(*best, *candidate)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// Running totals. Par makes three passes: scan each chunk on its own,
+// scan the chunk totals, then add each chunk's offset to its outputs.
+template<class ForwardIt, class OutputIt, class BinaryOp = std::plus<>>
+OutputIt inclusive_scan(ForwardIt first, ForwardIt last, OutputIt d_first, BinaryOp op = BinaryOp(),
+                        MyExecPolicy policy = MyExecPolicy::Seq) {
+    if (policy == MyExecPolicy::Seq || first == last) {
+        return std::partial_sum(first, last, d_first, op);
+    }
+    using T = detail::value_t<ForwardIt>;
+    auto bounds = detail::chunkBounds(first, last, sizeof(T));
+    size_t chunks = bounds.size() - 1;
+    std::vector<OutputIt> outputs { d_first };
+    for (size_t i = 0; i < chunks; ++i) {
+        outputs.push_back(std::next(outputs.back(), std::distance(bounds[i], bounds[i + 1])));
+    }
+
+    std::vector<T> totals(chunks);
+    detail::forEachChunk(bounds, [&](size_t i) {
+        std::partial_sum(bounds[i], bounds[i + 1], outputs[i], op);
+        totals[i] = *std::prev(outputs[i + 1]);
+    });
+    for (size_t i = 1; i < chunks; ++i) {
+        totals[i] = op(totals[i - 1], totals[i]);
+    }
+    detail::forEachChunk(bounds, [&](size_t i) {
+        if (i > 0) {
+            for (auto it = outputs[i]; it != outputs[i + 1]; ++it) {
+                *it = op(totals[i - 1], *it);
+            }
+        }
+    });
+    return outputs.back();
+}
+
+// Par sorts the chunks, then merges neighbours pairwise, halving the
+// number of runs each round, with the merges of a round in parallel.
+template<class RandomIt, class Compare = std::less<>>
+void sort(RandomIt first, RandomIt last, Compare comp = Compare(), MyExecPolicy policy = MyExecPolicy::Seq) {
+    if (policy == MyExecPolicy::Seq || first == last) {
+        std::sort(first, last, comp);
+        return;
+    }
+    auto bounds = detail::chunkBounds(first, last, sizeof(detail::value_t<RandomIt>));
+    detail::forEachChunk(bounds, [&](size_t i) {
+        std::sort(bounds[i], bounds[i + 1], comp);
+    });
+    while (bounds.size() > 2) {
+        size_t runs = bounds.size() - 1;
+        WorkStealingPool::Instance().ParallelFor(runs / 2, [&](size_t pair) {
+            std::inplace_merge(bounds[2 * pair], bounds[2 * pair + 1], bounds[2 * pair + 2], comp);
+        });
+        std::vector<RandomIt> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (runs % 2 == 1) {
+            merged.push_back(bounds.back());
+        }
+        bounds = merged;
+    }
+}
+
+} // namespace my
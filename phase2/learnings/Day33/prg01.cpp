@@ -1,30 +1,23 @@
 #include<iostream>
 #include<thread>
-#include<shared_mutex>
-#include<mutex>
 #include<chrono>
 #include<vector>
-long TIMES = 5000000L;
-long count = 0;
 
-std::shared_mutex mt;
+#include "seq_lock.h"
+
+long TIMES = 5000000L;
+SeqLock<long> count(0);    // readers never write shared memory
 
 void counter() {
     for(long I = 1; I <= TIMES; I++) {
-        {
-            std::unique_lock<std::shared_mutex> lock(mt);
-            count++;
-        }
+        count.Update([](long& value) { value++; });
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 }
 
 void displayCount(int id) {
     for(long I = 1; I <= TIMES; I++) {
-        {
-            std::shared_lock<std::shared_mutex> lock(mt);
-            std::cout << "At " << id << ":" << count << std::endl; 
-        }
+        std::cout << "At " << id << ":" << count.Load() << std::endl;
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
 }
@@ -45,7 +38,7 @@ int main() {
     */
     
     thrCounter.join();
-    for(int I = 1; I <= 3; I++) {
+    for(int I = 0; I < 3; I++) {
         thrDisplays[I].join();
     }
     /*
@@ -1,5 +1,4 @@
 //Parallel algo is optimized here
-//NOTE:: NOT DONE 
 
 #include <iostream>
 #include <vector>
@@ -10,10 +9,10 @@
 #include <set>
 #include <thread>
 #include <iterator>
+#include <algorithm>
+#include <chrono>
 
-enum class MyExecPolicy {
-    Seq = 1, Par = 2
-};
+#include "work_stealing_pool.h"
 
 template<class InputIt, class T> 
 T findSum(InputIt first, InputIt last, T init, MyExecPolicy policy = MyExecPolicy::Seq) {
@@ -25,40 +24,35 @@ T findSum(InputIt first, InputIt last, T init, MyExecPolicy policy = MyExecPolic
         }
         return sum;
     };
-    auto tFindSum = [saFindSum](InputIt first, InputIt last, T init, T& result) -> void {
-        T sum = saFindSum(first, last, init);
-        //std::cout << "Parallel algo" << std::endl;
-        result = sum;
-    };
     if (policy == MyExecPolicy::Seq) {
         return saFindSum(first, last, init);
     } else if (policy == MyExecPolicy::Par) {
-        // Parallel algorithm
+        // Parallel algorithm: a few chunks per pool worker, so a slow chunk
+        // is balanced by idle workers stealing the rest
+        WorkStealingPool& pool = WorkStealingPool::Instance();
         auto distance = std::distance(first, last);
-        const int maxThreads = std::thread::hardware_concurrency(); // Get number of threads supported by hardware
-        const int numThreads = std::min(static_cast<int>(distance), maxThreads);//slices
-        const int chunkSize = distance / numThreads; //slice_size 
-        std::cout << distance << "," << maxThreads 
-                         << "," << numThreads 
-                         << "," << chunkSize << std::endl; 
-        std::vector<std::thread> workers;
-        std::vector<T> results;
-        auto chunkFirst = first;
-        for (int i = 0; i < numThreads; ++i) {
-            auto chunkLast = (i == numThreads - 1) ? last : std::next(chunkFirst, chunkSize);
-            std::cout << chunkSize << "+chunks:" << std::distance(chunkFirst, chunkLast) << std::endl;
-            results.push_back(init);
-            workers.emplace_back(tFindSum, chunkFirst, chunkLast, init, std::ref(results[i]));
+        const long numChunks = std::min(static_cast<long>(distance), 4L * pool.Size());
+        if (numChunks <= 1) {
+            return saFindSum(first, last, init);
         }
-        for (int i = 0; i < numThreads; ++i) {
-            workers[i].join();
+        const long chunkSize = distance / numChunks;
+
+        std::vector<InputIt> bounds { first };
+        for (long i = 1; i < numChunks; ++i) {
+            bounds.push_back(std::next(bounds.back(), chunkSize));
         }
-        T totalSum = init;
-        for (int i = 0; i < numThreads; ++i) {
-            std::cout << "total at " << i << ":" << results[i] << std::endl;
-            totalSum = totalSum + results[i];
-        }       
+        bounds.push_back(last);
 
+        std::vector<T> results(numChunks, T(0));
+        pool.ParallelFor(numChunks, [&](size_t i) {
+            results[i] = saFindSum(bounds[i], bounds[i + 1], T(0));
+        });
+
+        // Combine results from all chunks
+        T totalSum = init;
+        for (const T& result : results) {
+            totalSum += result;
+        }
         return totalSum;
     }
 
@@ -83,11 +77,32 @@ int test() {
     return 0;
 }
 
+// Many parallel reductions in a row: the pool's threads are reused, so
+// each call costs a few task hand-offs rather than thread start-ups.
+void testRepeated() {
+    std::vector<double> salaries(1000000);
+    for (size_t i = 0; i < salaries.size(); ++i) {
+        salaries[i] = 1000 + i % 1000;
+    }
+    const int rounds = 200;
+    for (MyExecPolicy policy : { MyExecPolicy::Seq, MyExecPolicy::Par }) {
+        auto start = std::chrono::steady_clock::now();
+        double sum = 0;
+        for (int round = 0; round < rounds; ++round) {
+            sum = findSum(salaries.begin(), salaries.end(), 0.0, policy);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << (policy == MyExecPolicy::Par ? "Par" : "Seq") << ": sum " << sum << ", "
+                  << rounds << " rounds in " << seconds << "s" << std::endl;
+    }
+}
+
 int main() {
     int t = 1;
     while (t--) {
         test();
     }
+    testRepeated();
     return 0;
 }
 
@@ -0,0 +1,89 @@
+//parallel algorithms with MyExecPolicy: the same call runs Seq or Par
+//salaries, temperatures, doctors' experience
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <chrono>
+#include <random>
+
+#include "par_algorithms.h"
+
+struct Doctor {
+    int id;
+    short yearsOfExperience;
+};
+
+template<class Work>
+void timeIt(const std::string& name, Work work) {
+    for (MyExecPolicy policy : { MyExecPolicy::Seq, MyExecPolicy::Par }) {
+        auto start = std::chrono::steady_clock::now();
+        std::string result = work(policy);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << (policy == MyExecPolicy::Par ? " [Par] " : " [Seq] ")
+                  << result << " (" << ms << " ms)" << std::endl;
+    }
+}
+
+int test() {
+    const size_t N = 4000000;
+    std::mt19937 random(42);
+
+    std::vector<double> salaries(N);
+    for (auto& salary : salaries) {
+        salary = 10000 + random() % 90000;
+    }
+    std::vector<double> temperatures(N);
+    for (auto& temperature : temperatures) {
+        temperature = -10 + (random() % 5500) / 100.0;
+    }
+    std::vector<Doctor> doctors(N);
+    for (size_t i = 0; i < N; i++) {
+        doctors[i] = Doctor { (int)i, (short)(random() % 40) };
+    }
+
+    timeIt("total salary          ", [&](MyExecPolicy policy) {
+        return std::to_string(my::reduce(salaries.begin(), salaries.end(), 0.0, policy));
+    });
+    timeIt("highest salary        ", [&](MyExecPolicy policy) {
+        return std::to_string(*my::max_element(salaries.begin(), salaries.end(), std::less<>(), policy));
+    });
+    timeIt("coldest, hottest      ", [&](MyExecPolicy policy) {
+        return std::to_string(*my::min_element(temperatures.begin(), temperatures.end(), std::less<>(), policy))
+            + ", " + std::to_string(*my::max_element(temperatures.begin(), temperatures.end(), std::less<>(), policy));
+    });
+    timeIt("days above 40         ", [&](MyExecPolicy policy) {
+        return std::to_string(my::count_if(temperatures.begin(), temperatures.end(),
+            [](double temperature) { return temperature > 40; }, policy));
+    });
+    timeIt("doctors' experience   ", [&](MyExecPolicy policy) {
+        return std::to_string(my::transform_reduce(doctors.begin(), doctors.end(), 0L, std::plus<>(),
+            [](const Doctor& doctor) { return (long)doctor.yearsOfExperience; }, policy));
+    });
+    timeIt("running payroll       ", [&](MyExecPolicy policy) {
+        std::vector<double> running(N);
+        my::inclusive_scan(salaries.begin(), salaries.end(), running.begin(), std::plus<>(), policy);
+        return std::to_string(running.back());
+    });
+    timeIt("sorted salaries       ", [&](MyExecPolicy policy) {
+        std::vector<double> sorted = salaries;
+        my::sort(sorted.begin(), sorted.end(), std::less<>(), policy);
+        return std::to_string(sorted.front()) + " .. " + std::to_string(sorted.back())
+            + (std::is_sorted(sorted.begin(), sorted.end()) ? " sorted" : " NOT SORTED");
+    });
+
+    // any container, as findSum
+    std::list<double> l {1, 2, 3, 4, 5}; //15
+    std::cout << my::reduce(l.begin(), l.end(), 0.0, MyExecPolicy::Par) << std::endl;
+
+    return 0;
+}
+
+int main() {
+    int t = 1;
+    while(t--) {
+        test();
+    }
+    return 0;
+}
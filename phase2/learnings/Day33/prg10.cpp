@@ -0,0 +1,52 @@
+//counter problem - three fixes side by side
+//  mutex (Day32/prg06), one shared atomic (prg02), sharded counter
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <chrono>
+
+#include "sharded_counter.h"
+
+const long long TIMES = 20000000LL;     // increments per run, over all threads
+
+long long mutexCount;
+std::mutex mt;
+std::atomic<long long> atomicCount;
+ShardedCounter shardedCount;
+
+template<class Increment>
+double run(int threads, Increment increment) {
+    std::vector<std::thread> thrCounters;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        thrCounters.emplace_back([threads, increment] {
+            for (long long I = 0; I < TIMES / threads; I++) {
+                increment();
+            }
+        });
+    }
+    for (auto& thrCounter : thrCounters) {
+        thrCounter.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return (TIMES / threads * threads) / seconds / 1e6;
+}
+
+int main() {
+    std::cout << "threads\tmutex\tatomic\tsharded (M increments/s)" << std::endl;
+    for (int threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        mutexCount = 0;
+        atomicCount = 0;
+        shardedCount.Reset();
+        double locked = run(threads, [] { std::lock_guard<std::mutex> lock(mt); mutexCount++; });
+        double atomic = run(threads, [] { atomicCount.fetch_add(1); });
+        double sharded = run(threads, [] { shardedCount.Add(); });
+        long long expected = TIMES / threads * threads;
+        bool exact = mutexCount == expected && atomicCount == expected && shardedCount.Read() == expected;
+        std::cout << threads << "\t" << (long)locked << "\t" << (long)atomic << "\t" << (long)sharded
+                  << (exact ? "" : "\tCOUNT MISMATCH") << std::endl;
+    }
+    return 0;
+}
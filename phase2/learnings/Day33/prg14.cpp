@@ -0,0 +1,124 @@
+//bank ledger - many accounts, many threads
+//  one mutex for the whole bank (Day32/prg03) vs. BankLedger
+//  mix per thread: 50% transfers, 25% deposits, 25% withdrawals
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+#include "bank_ledger.h"
+
+const long long OPENING_BALANCE = 100;
+
+// the obvious fix: every operation under one lock
+class LockedBank {
+    private:
+        std::mutex mt;
+        std::vector<long long> balances;
+    public:
+        LockedBank(size_t accounts, long long openingBalance) : balances(accounts, openingBalance) {}
+
+        void Deposit(size_t account, long long amount) {
+            std::lock_guard<std::mutex> lock(mt);
+            balances[account] += amount;
+        }
+        bool Withdraw(size_t account, long long amount) {
+            std::lock_guard<std::mutex> lock(mt);
+            if (balances[account] < amount) {
+                return false;
+            }
+            balances[account] -= amount;
+            return true;
+        }
+        bool Transfer(size_t from, size_t to, long long amount) {
+            std::lock_guard<std::mutex> lock(mt);
+            if (balances[from] < amount) {
+                return false;
+            }
+            balances[from] -= amount;
+            balances[to] += amount;
+            return true;
+        }
+        long long Total() {
+            std::lock_guard<std::mutex> lock(mt);
+            long long total = 0;
+            for (long long balance : balances) {
+                total += balance;
+            }
+            return total;
+        }
+};
+
+// Runs the mix on `threads` threads; checks that no money appeared or
+// vanished and no balance went negative.
+template<class Bank>
+void run(const char* name, Bank& bank, size_t accounts, int threads, long operations) {
+    std::atomic<long long> deposited { 0 }, withdrawn { 0 };
+    std::atomic<long> refused { 0 };
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::minstd_rand random(t + 1);
+            long long in = 0, out = 0;
+            long no = 0;
+            for (long I = 0; I < operations / threads; I++) {
+                size_t account = random() % accounts;
+                long long amount = 1 + random() % 50;
+                switch (random() % 4) {
+                    case 0:
+                        bank.Deposit(account, amount);
+                        in += amount;
+                        break;
+                    case 1:
+                        if (bank.Withdraw(account, amount)) {
+                            out += amount;
+                        } else {
+                            no++;
+                        }
+                        break;
+                    default:
+                        if (!bank.Transfer(account, random() % accounts, amount)) {
+                            no++;
+                        }
+                }
+            }
+            deposited += in;
+            withdrawn += out;
+            refused += no;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long expected = (long long)accounts * OPENING_BALANCE + deposited - withdrawn;
+    long long total = bank.Total();
+    std::cout << name << " threads " << threads << ": " << (long)(operations / threads * threads / seconds)
+              << " ops/s, " << refused << " refused (overdraft)"
+              << (total == expected ? ", total ok" : ", TOTAL WRONG") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t accounts = argc > 1 ? atol(argv[1]) : 1000000;
+    long operations = argc > 2 ? atol(argv[2]) : 4000000;
+    std::cout << accounts << " accounts, " << operations << " operations per run" << std::endl;
+    for (int threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        auto locked = std::make_unique<LockedBank>(accounts, OPENING_BALANCE);
+        run("one mutex ", *locked, accounts, threads, operations);
+        auto ledger = std::make_unique<BankLedger>(accounts, OPENING_BALANCE);
+        run("BankLedger", *ledger, accounts, threads, operations);
+        for (size_t i = 0; i < accounts; i++) {
+            if (ledger->GetBalance(i) < 0) {
+                std::cout << "account " << i << " overdrawn" << std::endl;
+                break;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+//futures with continuations (prg12, prg13 without blocking per result)
+//  add: p+q, r+m then the two results combined
+//  sum of slices: fan out one task per slice, fan in with when_all
+//  lookup: ask every replica, take whichever answers first (when_any)
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <numeric>
+#include <stdexcept>
+
+#include "my_future.h"
+
+double add(double a, double b) {
+    return a + b;
+}
+
+double sumSlice(const std::vector<double>& values, size_t first, size_t last) {
+    return std::accumulate(values.begin() + first, values.begin() + last, 0.0);
+}
+
+// a replica answers after its own delay; replica 0 is down
+std::string lookup(int replica, int doctorId) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(30 - 10 * replica));
+    if (replica == 0) {
+        throw std::runtime_error("replica 0 unavailable");
+    }
+    return "doctor " + std::to_string(doctorId) + " from replica " + std::to_string(replica);
+}
+
+int main() {
+    double p = 10, q = 3, r = 4, m = 7; //p+q, r+m // 13,11
+    auto future1 = my::async(add, p, q);
+    auto future2 = my::async(add, r, m);
+    auto both = my::when_all(std::vector<my::future<double>> { future1, future2 })
+        .then([](const std::vector<double>& sums) { return sums[0] + sums[1]; });
+    std::cout << future1.get() << ", " << future2.get() << " -> " << both.get() << std::endl; //13, 11 -> 24
+
+    const size_t N = 10000000, SLICES = 16;
+    std::vector<double> salaries(N, 1.5);
+    std::vector<my::future<double>> slices;
+    for (size_t s = 0; s < SLICES; s++) {
+        slices.push_back(my::async([&salaries](size_t first, size_t last) {
+            return sumSlice(salaries, first, last);
+        }, N * s / SLICES, N * (s + 1) / SLICES));
+    }
+    auto total = my::when_all(slices).then([](const std::vector<double>& sums) {
+        return std::accumulate(sums.begin(), sums.end(), 0.0);
+    });
+    std::cout << "total salary " << (long)total.get() << std::endl; //15000000
+
+    // the fastest replica (2) wins; the slow ones finish unobserved
+    std::vector<my::future<std::string>> replicas;
+    for (int replica = 1; replica <= 2; replica++) {
+        replicas.push_back(my::async(lookup, replica, 42));
+    }
+    auto first = my::when_any(replicas);
+    std::cout << first.get().second << " (index " << first.get().first << ")" << std::endl;
+
+    // a failed step skips the rest of the chain and get() rethrows
+    auto failed = my::async(lookup, 0, 7).then([](const std::string& doctor) { return doctor.size(); });
+    try {
+        failed.get();
+    } catch (const std::exception& e) {
+        std::cout << "lookup failed: " << e.what() << std::endl;
+    }
+    for (auto& replica : replicas) {
+        replica.wait();
+    }
+    return 0;
+}
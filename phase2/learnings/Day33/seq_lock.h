@@ -0,0 +1,82 @@
+#pragma once
+// Value published under a sequence lock, for data read far more often
+// than it changes. A writer makes the sequence odd, rewrites the value
+// and makes it even again; a reader copies the value between two reads
+// of the sequence and retries if a write overlapped the copy. Readers
+// only load shared memory, so any number of them can read without
+// bouncing a lock's cache line between cores, and they never block the
+// writer. Writers serialize on a mutex among themselves.
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+template<class T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "values are copied as raw words");
+    private:
+        static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        alignas(64) std::atomic<unsigned long> sequence { 0 };
+        // The value as relaxed atomic words, so a torn copy is a retry
+        // rather than a data race.
+        std::atomic<uint64_t> words[WORDS];
+        alignas(64) std::mutex writerMtx;
+
+        void Write_(const T& value) {
+            uint64_t buffer[WORDS] = {};
+            std::memcpy(buffer, &value, sizeof(T));
+            unsigned long begin = sequence.load(std::memory_order_relaxed);
+            sequence.store(begin + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; i++) {
+                words[i].store(buffer[i], std::memory_order_relaxed);
+            }
+            sequence.store(begin + 2, std::memory_order_release);
+        }
+    public:
+        explicit SeqLock(const T& value = T()) {
+            Write_(value);
+        }
+
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        // A consistent copy of the latest value.
+        T Load() const {
+            uint64_t buffer[WORDS];
+            while (true) {
+                unsigned long begin = sequence.load(std::memory_order_acquire);
+                if (begin % 2 == 0) {
+                    for (size_t i = 0; i < WORDS; i++) {
+                        buffer[i] = words[i].load(std::memory_order_relaxed);
+                    }
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence.load(std::memory_order_relaxed) == begin) {
+                        break;
+                    }
+                }
+                std::this_thread::yield();  // a write is in progress
+            }
+            T value;
+            std::memcpy(&value, buffer, sizeof(T));
+            return value;
+        }
+
+        void Store(const T& value) {
+            std::lock_guard<std::mutex> lock(writerMtx);
+            Write_(value);
+        }
+
+        // Read-modify-write: update(value) on a copy, then publish it.
+        // Writers are serialized, so no update is lost.
+        template<class Modify>
+        void Update(Modify update) {
+            std::lock_guard<std::mutex> lock(writerMtx);
+            T value = Load();
+            update(value);
+            Write_(value);
+        }
+};
@@ -0,0 +1,61 @@
+#pragma once
+// Counter split into cache-line-sized shards. Each thread adds to its own
+// shard, so counting threads no longer fight over one cache line the way
+// they do over a single std::atomic or a mutex; Read() adds the shards up.
+// Read() is not a snapshot: increments that race with it may or may not
+// be included, which is what request/byte counters need.
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+class ShardedCounter {
+    private:
+        struct alignas(64) Shard {
+            std::atomic<long long> value { 0 };
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        size_t mask;
+
+        // Threads are dealt shards round-robin, once, on first use.
+        static size_t ThreadSlot_() {
+            static std::atomic<size_t> nextSlot { 0 };
+            thread_local size_t slot = nextSlot++;
+            return slot;
+        }
+    public:
+        // shardCount is rounded up to a power of two; the default gives
+        // every hardware thread its own shard, with room to spare.
+        explicit ShardedCounter(size_t shardCount = 2 * std::thread::hardware_concurrency()) {
+            size_t size = 1;
+            while (size < shardCount) {
+                size <<= 1;
+            }
+            shards.reset(new Shard[size]);
+            mask = size - 1;
+        }
+
+        ShardedCounter(const ShardedCounter&) = delete;
+        ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+        // Atomic even though usually uncontended: once there are more
+        // threads than shards, two threads share a shard.
+        void Add(long long n = 1) {
+            shards[ThreadSlot_() & mask].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        long long Read() const {
+            long long total = 0;
+            for (size_t i = 0; i <= mask; i++) {
+                total += shards[i].value.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        void Reset() {
+            for (size_t i = 0; i <= mask; i++) {
+                shards[i].value.store(0, std::memory_order_relaxed);
+            }
+        }
+};
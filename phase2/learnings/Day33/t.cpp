@@ -1,4 +1,3 @@
-//NOTE:: NOT DONE 
 #include <iostream>
 #include <vector>
 #include <deque>
@@ -9,10 +8,9 @@
 #include <thread>
 #include <future>
 #include <iterator>
+#include <algorithm>
 
-enum class MyExecPolicy {
-    Seq = 1, Par = 2
-};
+#include "work_stealing_pool.h"
 
 template<class InputIt, class T> 
 T findSum(InputIt first, InputIt last, T init, MyExecPolicy policy = MyExecPolicy::Seq) {
@@ -28,29 +26,32 @@ T findSum(InputIt first, InputIt last, T init, MyExecPolicy policy = MyExecPolic
     if (policy == MyExecPolicy::Seq) {
         return saFindSum(first, last, init);
     } else if (policy == MyExecPolicy::Par) {
-        // Parallel algorithm
+        // Parallel algorithm: a few chunks per pool worker, so a slow chunk
+        // is balanced by idle workers stealing the rest
+        WorkStealingPool& pool = WorkStealingPool::Instance();
         auto distance = std::distance(first, last);
-        const int maxThreads = std::thread::hardware_concurrency(); // Get number of threads supported by hardware
-        const int numThreads = std::min(static_cast<int>(distance), maxThreads);
-        const int chunkSize = distance / numThreads;
-
-        std::vector<std::future<T>> futures;
-        futures.reserve(numThreads);
+        const long numChunks = std::min(static_cast<long>(distance), 4L * pool.Size());
+        if (numChunks <= 1) {
+            return saFindSum(first, last, init);
+        }
+        const long chunkSize = distance / numChunks;
 
-        // Divide the work among threads
-        auto chunkFirst = first;
-        for (int i = 0; i < numThreads; ++i) {
-            auto chunkLast = (i == numThreads - 1) ? last : std::next(chunkFirst, chunkSize);
-            futures.push_back(std::async(std::launch::async, saFindSum, chunkFirst, chunkLast, T(0)));
-            chunkFirst = chunkLast;
+        std::vector<InputIt> bounds { first };
+        for (long i = 1; i < numChunks; ++i) {
+            bounds.push_back(std::next(bounds.back(), chunkSize));
         }
+        bounds.push_back(last);
 
-        // Combine results from all threads
+        std::vector<T> results(numChunks, T(0));
+        pool.ParallelFor(numChunks, [&](size_t i) {
+            results[i] = saFindSum(bounds[i], bounds[i + 1], T(0));
+        });
+
+        // Combine results from all chunks
         T totalSum = init;
-        for (auto& future : futures) {
-            totalSum += future.get();
+        for (const T& result : results) {
+            totalSum += result;
         }
-
         return totalSum;
     }
 
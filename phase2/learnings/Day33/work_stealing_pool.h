@@ -0,0 +1,200 @@
+#pragma once
+// Process-wide pool of long-lived worker threads with work stealing.
+// Every worker owns a deque: it pushes and pops its own tasks at the back
+// (newest first, still warm in cache) while idle workers steal from the
+// front of a randomly chosen victim (oldest first, usually the biggest
+// pieces of work). Uneven chunks therefore even out on their own, and
+// parallel calls reuse the same threads instead of creating new ones.
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <random>
+#include <exception>
+
+// How an algorithm should run: Seq on the calling thread, Par as chunks on
+// the pool. Defined once here so findSum and par_algorithms.h share it.
+enum class MyExecPolicy {
+    Seq = 1, Par = 2
+};
+
+class WorkStealingPool {
+    private:
+        struct Worker {
+            std::mutex mtx;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        std::atomic<long> queued { 0 };
+        std::atomic<unsigned> nextVictim { 0 };
+        std::atomic<bool> stopping { false };
+        std::mutex sleepMtx;
+        std::condition_variable wakeUp;
+
+        // index of the calling thread's worker in this pool, or -1
+        static thread_local WorkStealingPool* currentPool;
+        static thread_local int currentIndex;
+
+        bool PopLocal_(int index, std::function<void()>& task) {
+            Worker& worker = *workers[index];
+            std::lock_guard<std::mutex> lock(worker.mtx);
+            if (worker.tasks.empty()) {
+                return false;
+            }
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+
+        bool Steal_(std::function<void()>& task) {
+            static thread_local std::minstd_rand random(std::random_device{}());
+            size_t count = workers.size();
+            size_t start = random() % count;
+            for (size_t i = 0; i < count; i++) {
+                Worker& victim = *workers[(start + i) % count];
+                std::lock_guard<std::mutex> lock(victim.mtx);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool Take_(std::function<void()>& task) {
+            bool mine = currentPool == this && PopLocal_(currentIndex, task);
+            if (mine || Steal_(task)) {
+                queued--;
+                return true;
+            }
+            return false;
+        }
+
+        void Run_(int index) {
+            currentPool = this;
+            currentIndex = index;
+            std::function<void()> task;
+            while (true) {
+                if (Take_(task)) {
+                    task();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleepMtx);
+                wakeUp.wait(lock, [this] { return queued > 0 || stopping; });
+                if (stopping && queued == 0) {
+                    return;
+                }
+            }
+        }
+    public:
+        explicit WorkStealingPool(unsigned size = std::thread::hardware_concurrency()) {
+            size = size > 0 ? size : 1;
+            for (unsigned i = 0; i < size; i++) {
+                workers.push_back(std::make_unique<Worker>());
+            }
+            for (unsigned i = 0; i < size; i++) {
+                threads.emplace_back(&WorkStealingPool::Run_, this, (int)i);
+            }
+        }
+
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(sleepMtx);
+                stopping = true;
+            }
+            wakeUp.notify_all();
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // The shared pool, one worker per hardware thread.
+        static WorkStealingPool& Instance() {
+            static WorkStealingPool pool;
+            return pool;
+        }
+
+        unsigned Size() const { return workers.size(); }
+
+        // From a worker the task goes on its own deque; from any other
+        // thread it is dealt to the workers round-robin.
+        void Submit(std::function<void()> task) {
+            int index = currentPool == this ? currentIndex : (int)(nextVictim++ % workers.size());
+            {
+                std::lock_guard<std::mutex> lock(workers[index]->mtx);
+                workers[index]->tasks.push_back(std::move(task));
+            }
+            queued++;
+            {
+                std::lock_guard<std::mutex> lock(sleepMtx);   // no lost wake-up
+            }
+            wakeUp.notify_one();
+        }
+
+        // Run one queued task on the calling thread; false if none was found.
+        bool RunPendingTask() {
+            std::function<void()> task;
+            if (!Take_(task)) {
+                return false;
+            }
+            task();
+            return true;
+        }
+
+        // body(i) for every i in [0, count) on the pool; returns when all are
+        // done. The caller runs queued tasks while it waits, so nested calls
+        // from inside a task cannot starve the pool. The first exception
+        // thrown by body is rethrown here.
+        template<class Body>
+        void ParallelFor(size_t count, Body body) {
+            if (count == 0) {
+                return;
+            }
+            std::atomic<size_t> remaining { count };
+            std::exception_ptr error;
+            std::mutex errorMtx;
+            for (size_t i = 1; i < count; i++) {
+                Submit([&, i] {
+                    try {
+                        body(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMtx);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    remaining--;
+                });
+            }
+            try {
+                body(0);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMtx);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            remaining--;
+            while (remaining > 0) {
+                if (!RunPendingTask()) {
+                    std::this_thread::yield();
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+};
+
+inline thread_local WorkStealingPool* WorkStealingPool::currentPool = nullptr;
+inline thread_local int WorkStealingPool::currentIndex = -1;
@@ -5,11 +5,26 @@
 // roomOne, roomTwo | roomOne is initiator 
 // strategy: [a] two childs [b] parent-child [c] two prcoesses 
 // single word based communication 
+// multiplexed modes (4, 5): each message is a frame [length: 4 bytes][text],
+//      and a room polls its read pipe, its write pipe and the keyboard
+//      together, so either side may send any number of lines at any time
 #include<iostream>
 #include<unistd.h>
 #include<cstring>
 #include <sys/wait.h>
+#include <sys/stat.h>
 #include <fstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <chrono>
+
+#define SUN_FIFO "sun.fifo"
+#define MOON_FIFO "moon.fifo"
+#define BURST_MESSAGES 1000000
+#define OUTBOX_LIMIT (64 * 1024)
 
 void roomOne(int& moonReadFd, int& sunWriteFd) {
     while(true) {
@@ -50,6 +65,135 @@ void roomTwo(int& sunReadFd, int& moonWriteFd) {
     close(sunReadFd);
 }
 
+void appendFrame(std::string& outbox, const std::string& text) {
+    uint32_t length = text.size();
+    outbox.append((const char*)&length, sizeof(length));
+    outbox.append(text);
+}
+
+// Split complete frames off the bytes read so far; a frame cut by a
+// partial read stays in `pending` until the rest arrives.
+template<class OnMessage>
+void takeFrames(std::string& pending, OnMessage onMessage) {
+    size_t at = 0;
+    uint32_t length;
+    while (pending.size() - at >= sizeof(length)) {
+        memcpy(&length, pending.data() + at, sizeof(length));
+        if (pending.size() - at - sizeof(length) < length) {
+            break;
+        }
+        onMessage(pending.substr(at + sizeof(length), length));
+        at += sizeof(length) + length;
+    }
+    pending.erase(0, at);
+}
+
+// A room that never blocks on one direction: poll() waits on the peer's
+// pipe, on its own pipe while there is something to send, and on the
+// keyboard. "END" (or Ctrl+D) from this room closes its sending side;
+// the room is done when both sides have finished.
+// With burst > 0 the room sends that many messages itself instead of
+// reading the keyboard, and reports messages/sec.
+void roomMultiplexed(const char* self, const char* peer, int readFd, int writeFd, long burst) {
+    fcntl(readFd, F_SETFL, fcntl(readFd, F_GETFL) | O_NONBLOCK);
+    fcntl(writeFd, F_SETFL, fcntl(writeFd, F_GETFL) | O_NONBLOCK);
+
+    std::string outbox, inbox, typed;
+    size_t outSent = 0;
+    bool sending = true;    // more messages may still be queued
+    bool peerOpen = true;
+    long sent = 0, received = 0;
+    char buffer[64 * 1024];
+    auto start = std::chrono::steady_clock::now();
+
+    while (peerOpen || writeFd >= 0) {
+        if (burst > 0 && sending) {
+            while (sent < burst && outbox.size() - outSent < OUTBOX_LIMIT) {
+                appendFrame(outbox, std::string(self) + " message " + std::to_string(sent++));
+            }
+            if (sent == burst) {
+                appendFrame(outbox, "END");
+                sending = false;
+            }
+        }
+
+        pollfd fds[3] = {
+            { peerOpen ? readFd : -1, POLLIN, 0 },
+            { outSent < outbox.size() ? writeFd : -1, POLLOUT, 0 },
+            { burst == 0 && sending ? STDIN_FILENO : -1, POLLIN, 0 },
+        };
+        if (poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+
+        if (fds[0].revents) {
+            ssize_t n;
+            while ((n = read(readFd, buffer, sizeof(buffer))) > 0) {
+                inbox.append(buffer, n);
+            }
+            takeFrames(inbox, [&](const std::string& text) {
+                if (text == "END") {
+                    peerOpen = false;
+                    return;
+                }
+                received++;
+                if (burst == 0) {
+                    std::cout << "(" << self << " app) " << peer << ":" << text << std::endl;
+                }
+            });
+            if (n == 0) {
+                peerOpen = false;
+            }
+        }
+
+        if (fds[2].revents) {
+            ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (n > 0) {
+                typed.append(buffer, n);
+            }
+            size_t newline;
+            while (sending && (newline = typed.find('\n')) != std::string::npos) {
+                std::string line = typed.substr(0, newline);
+                typed.erase(0, newline + 1);
+                appendFrame(outbox, line);
+                sending = line != "END";
+            }
+            if (n <= 0 && sending) {
+                appendFrame(outbox, "END");
+                sending = false;
+            }
+        }
+
+        while (outSent < outbox.size()) {
+            ssize_t n = write(writeFd, outbox.data() + outSent, outbox.size() - outSent);
+            if (n <= 0) {
+                break;
+            }
+            outSent += n;
+        }
+        if (outSent == outbox.size()) {
+            outbox.clear();
+            outSent = 0;
+            if (!sending && writeFd >= 0) {
+                close(writeFd);
+                writeFd = -1;
+            }
+        }
+    }
+    close(readFd);
+
+    if (burst > 0) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "(" << self << " app) sent " << sent << ", received " << received
+                  << " in " << seconds << "s = " << (long)((sent + received) / seconds)
+                  << " msgs/s" << std::endl;
+    }
+}
+
 int testTwoChilds() {
     std::cout << "----------------------Two Childs---------------------------" << std::endl;
     int sun_fd[2];
@@ -166,14 +310,77 @@ int testProcesses() {
     wait(nullptr);
     return 0;
 }
+// Each room runs in its own terminal and they meet through two named
+// pipes, so both can type freely.
+int testMultiplexed() {
+    std::cout << "----------------------Two Terminals, Multiplexed (named pipes)---------------------------" << std::endl;
+    int choice;
+    std::cout << "1-Room One\n2-Room Two\nYour Choice:"; std::cin >> choice;
+
+    if ((mkfifo(SUN_FIFO, 0666) == -1 && errno != EEXIST) ||
+        (mkfifo(MOON_FIFO, 0666) == -1 && errno != EEXIST)) {
+        perror("mkfifo");
+        return 1;
+    }
+    // open our read side without waiting, then wait for the peer's
+    const char* readPath = choice == 1 ? MOON_FIFO : SUN_FIFO;
+    const char* writePath = choice == 1 ? SUN_FIFO : MOON_FIFO;
+    int readFd = open(readPath, O_RDONLY | O_NONBLOCK);
+    std::cout << "waiting for the other room..." << std::endl;
+    int writeFd = open(writePath, O_WRONLY);
+    if (readFd == -1 || writeFd == -1) {
+        perror("open");
+        return 1;
+    }
+    std::cout << "connected; type lines, END to leave" << std::endl;
+    if (choice == 1) {
+        roomMultiplexed("roomOne", "roomTwo", readFd, writeFd, 0);
+    } else {
+        roomMultiplexed("roomTwo", "roomOne", readFd, writeFd, 0);
+    }
+    return 0;
+}
+
+// Both rooms send BURST_MESSAGES at once over anonymous pipes.
+int testBurst() {
+    std::cout << "----------------------Burst Benchmark (multiplexed)---------------------------" << std::endl;
+    int sun_fd[2];
+    int moon_fd[2];
+    if(pipe(sun_fd) == -1 || pipe(moon_fd)==-1) {
+        perror("pipe");
+        std::cout << "Pipes cannot be created" << std::endl;
+        return 1;
+    }
+
+    auto& [sun_read_fd, sun_write_fd] = sun_fd;
+    auto& [moon_read_fd, moon_write_fd] = moon_fd;
+
+    pid_t pid = fork();
+    if(0 == pid) {
+        close(sun_write_fd);
+        close(moon_read_fd);
+        roomMultiplexed("roomTwo", "roomOne", sun_read_fd, moon_write_fd, BURST_MESSAGES);
+        return 0;
+    }
+
+    close(moon_write_fd);
+    close(sun_read_fd);
+    roomMultiplexed("roomOne", "roomTwo", moon_read_fd, sun_write_fd, BURST_MESSAGES);
+    wait(nullptr);
+    return 0;
+}
+
 int main() {
     int menu;
-    std::cout << "1-Two Child Process\n2-Parent and Child Process\n3-Two Process\nYour Choice:"; std::cin >> menu;
+    std::cout << "1-Two Child Process\n2-Parent and Child Process\n3-Two Process\n"
+              << "4-Two Terminals, Multiplexed\n5-Burst Benchmark\nYour Choice:"; std::cin >> menu;
 
     switch(menu) {
         case 1: testTwoChilds(); break;
         case 2: testParentChild(); break;
         case 3: testProcesses(); break;
+        case 4: testMultiplexed(); break;
+        case 5: testBurst(); break;
     }
     
     return 0;
@@ -0,0 +1,115 @@
+#pragma once
+#include <sys/msg.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <type_traits>
+
+#define MESSAGE_BYTES 8192  // default msgmax: the largest single message
+
+// One direction of traffic over a System V message queue.
+// Records are packed into packets of up to `Batch` records, so a sender
+// makes one msgsnd per packet instead of one per record. Every packet
+// carries the channel's mtype; a receiver asks msgrcv for that mtype only,
+// so several producer/consumer pairs can share one queue, each consumer
+// seeing just its own channel. close() sends an empty packet that ends
+// the receiver's stream.
+template<class Record, size_t Batch = (MESSAGE_BYTES - 2 * sizeof(uint64_t)) / sizeof(Record)>
+class MessageChannel {
+    static_assert(std::is_trivially_copyable<Record>::value, "records travel as raw bytes");
+    private:
+        struct Packet {
+            long mtype;
+            uint32_t count;
+            Record records[Batch];
+        };
+
+        static_assert(sizeof(Packet) - sizeof(long) <= MESSAGE_BYTES, "packet larger than msgmax");
+
+        int msgid;
+        size_t limit;           // records per packet, at most Batch
+        Packet packet;          // being filled (sender) or drained (receiver)
+        size_t next = 0;        // receiver: next record of packet to hand out
+        bool ended = false;
+        unsigned long records = 0;
+        unsigned long packets = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        // msgsnd/msgrcv size: everything after mtype, padding included
+        static size_t Bytes_(size_t count) {
+            return offsetof(Packet, records) - offsetof(Packet, count) + count * sizeof(Record);
+        }
+
+        void Send_() {
+            while (msgsnd(msgid, &packet, Bytes_(packet.count), 0) == -1) {
+                if (errno != EINTR) {
+                    perror("msgsnd failed");
+                    exit(1);
+                }
+            }
+            packets++;
+            packet.count = 0;
+        }
+    public:
+        // mtype must be > 0; it is the channel's routing key in the queue.
+        // A smaller limit sends smaller packets (1 = one msgsnd per record).
+        MessageChannel(int msgid, long mtype, size_t limit = Batch)
+            : msgid(msgid), limit(limit == 0 || limit > Batch ? Batch : limit) {
+            packet.mtype = mtype;
+            packet.count = 0;
+        }
+
+        void Send(const Record& record) {
+            packet.records[packet.count++] = record;
+            records++;
+            if (packet.count == limit) {
+                Send_();
+            }
+        }
+
+        void Flush() {
+            if (packet.count > 0) {
+                Send_();
+            }
+        }
+
+        // Flush and tell the receiver there is no more.
+        void Close() {
+            Flush();
+            Send_();
+        }
+
+        // Next record on this channel; false once the sender has closed it.
+        bool Receive(Record& record) {
+            while (next == packet.count) {
+                if (ended) {
+                    return false;
+                }
+                long mtype = packet.mtype;
+                if (msgrcv(msgid, &packet, Bytes_(Batch), mtype, 0) == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    perror("msgrcv failed");
+                    exit(1);
+                }
+                packets++;
+                next = 0;
+                ended = packet.count == 0;
+            }
+            record = packet.records[next++];
+            records++;
+            return true;
+        }
+
+        void Report(const char* name) const {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << name << " [mtype " << packet.mtype << "]: " << records << " records in "
+                      << packets << " messages, " << seconds << "s = "
+                      << (long)(records / seconds) << " records/s" << std::endl;
+        }
+};
@@ -5,8 +5,13 @@
 #include<sys/msg.h>
 #include<sys/wait.h>
 #include<cstring>
+#include<cstdlib>
+#include<vector>
+
+#include "message_channel.h"
 
 #define MSG_KEY 1234
+#define QUEUE_BYTES (1 << 20)
 struct msgbuf_t {
     long mtype;
     char mtext[6];
@@ -31,7 +36,74 @@ void server(int& msgid) { //child 2
     }
     std::cout << "message sent successfully." << std::endl;
 }
-int main() { 
+struct Event {
+    long id;
+    int kind;
+    int value;
+};
+
+void consumer(int msgid, long mtype) {
+    MessageChannel<Event> channel(msgid, mtype);
+    Event event;
+    long sum = 0;
+    while (channel.Receive(event)) {
+        sum += event.value;
+    }
+    channel.Report("consumer");
+    std::cout << "\tsum of values: " << sum << std::endl;
+}
+
+// One producer feeding `consumers` channels (mtype 1..consumers) that
+// share a single queue; `batch` records per msgsnd.
+int bench(int consumers, long records, size_t batch) {
+    int msgid = msgget(IPC_PRIVATE, 0666 | IPC_CREAT);
+    if (msgid == -1) {
+        perror("msgget failed");
+        return 1;
+    }
+    // room for more than a couple of packets; needs privilege above msgmnb
+    msqid_ds info;
+    if (msgctl(msgid, IPC_STAT, &info) == 0) {
+        info.msg_qbytes = QUEUE_BYTES;
+        msgctl(msgid, IPC_SET, &info);
+    }
+
+    for (int c = 1; c <= consumers; c++) {
+        if (0 == fork()) {
+            consumer(msgid, c);
+            return 0;
+        }
+    }
+
+    std::vector<MessageChannel<Event>> channels;
+    for (int c = 1; c <= consumers; c++) {
+        channels.emplace_back(msgid, c, batch);
+    }
+    for (long id = 0; id < records; id++) {
+        channels[id % consumers].Send(Event { id, 0, (int)(id % 100) });
+    }
+    for (auto& channel : channels) {
+        channel.Close();
+        channel.Report("producer");
+    }
+
+    for (int c = 1; c <= consumers; c++) {
+        wait(nullptr);
+    }
+    msgctl(msgid, IPC_RMID, nullptr);
+    return 0;
+}
+
+// usage: ./a.out                                 hello demo
+//        ./a.out bench [consumers] [records] [batch]
+int main(int argc, char* argv[]) { 
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        int consumers = argc > 2 ? atoi(argv[2]) : 4;
+        long records = argc > 3 ? atol(argv[3]) : 1000000;
+        size_t batch = argc > 4 ? atol(argv[4]) : 0;    // 0: as many as fit
+        return bench(consumers > 0 ? consumers : 1, records, batch);
+    }
+
     int msgid = msgget(MSG_KEY, 0666 | IPC_CREAT);   
     
     pid_t pid = -1;
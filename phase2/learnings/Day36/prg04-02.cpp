@@ -1,62 +1,318 @@
 //two processing - concurrent programming
 //IPC (inter process communication) via shm
-// N salaries (client) + N revised salaries(server)
-// salary of double=8 x N=10 = 80 + 80 + 4 = 160 + 4 (after pad= 168)
+// client streams salaries to the server through one ring buffer in shared
+// memory and gets the revised salaries back through another; each ring has
+// exactly one producer and one consumer, so atomic head/tail are enough
+// (no locks), and a side with nothing to do sleeps on a futex instead of spinning.
+//   ./a.out          salaries read from the keyboard
+//   ./a.out 1000000  that many salaries generated, throughput reported
+//   ./a.out workers 8 50000000
+//                    one shared salary array revised by 8 forked workers
 #include<iostream>
 #include<unistd.h>
 #include<sys/ipc.h>
 #include<sys/shm.h>
 #include<sys/wait.h>
+#include<sys/syscall.h>
+#include<linux/futex.h>
 #include<cstring>
+#include<cstdlib>
+#include<climits>
+#include<cstdint>
 
-#define MAX_SIZE 200
+#include<atomic>
+#include<thread>
+#include<chrono>
 
-#define SHM_KEY 1234
-struct Payroll { 
-    double salaries[MAX_SIZE];
-    double revisedSalaries[MAX_SIZE];
-    int size;
-    int status; // 0-not read, 1-read, 2-processed, 3-used processed salaries
+#define RING_SIZE 4096      // slots per ring, a power of two
+#define RING_BATCH 256      // slots moved per push/pop at most
+#define SPIN_LIMIT 1000     // polls before sleeping on the futex
+#define WORK_CHUNK 65536    // salaries a worker claims at a time
+#define HIKE 1.1
+
+static void futexWait(std::atomic<uint32_t>* word, uint32_t expected) {
+    // not FUTEX_PRIVATE_FLAG: the word is shared between processes
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, expected, nullptr, nullptr, 0);
+}
+
+static void futexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Single-producer single-consumer ring living in shared memory.
+// head and tail only grow (wrapping at 2^32), slot = index % RING_SIZE.
+// The producer owns head, the consumer owns tail; each sits on its own
+// cache line so the two processes do not bounce one line between cores.
+// A side that finds the ring full (empty) spins SPIN_LIMIT times, then
+// raises its sleeping flag and futex-waits on its wakeup counter; the other
+// side bumps that counter and issues the wake only when the flag is up, so
+// a busy stream makes no system calls at all. Waiting on a counter rather
+// than on head/tail means close(), which moves no index, still changes the
+// word a sleeper compares against, and its wake cannot be lost.
+template<class T>
+struct SpscRing {
+    alignas(64) std::atomic<uint32_t> head;
+    alignas(64) std::atomic<uint32_t> tail;
+    alignas(64) std::atomic<uint32_t> producerSleeping;
+    std::atomic<uint32_t> consumerSleeping;
+    std::atomic<uint32_t> producerWakeups;  // futex word the producer sleeps on
+    std::atomic<uint32_t> consumerWakeups;  // futex word the consumer sleeps on
+    std::atomic<uint32_t> closed;
+    alignas(64) T items[RING_SIZE];
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared atomics must be lock-free");
+
+    void init() {
+        head = 0;
+        tail = 0;
+        producerSleeping = 0;
+        consumerSleeping = 0;
+        producerWakeups = 0;
+        consumerWakeups = 0;
+        closed = 0;
+    }
+
+    // Wait until ready(); `wakeups` is bumped by the other side's wake().
+    template<class Ready>
+    static void await(std::atomic<uint32_t>& wakeups, std::atomic<uint32_t>& sleeping, Ready ready) {
+        for (int spin = 0; spin < SPIN_LIMIT; spin++) {
+            if (ready()) {
+                return;
+            }
+        }
+        while (!ready()) {
+            uint32_t seen = wakeups.load();
+            sleeping.store(1);  // seq_cst: ordered before the re-check below
+            if (!ready()) {
+                futexWait(&wakeups, seen);
+            }
+            sleeping.store(0);
+        }
+    }
+
+    // Called after a change the other side may be waiting for (seq_cst, so
+    // either the sleeper's re-check sees the change or this sees its flag).
+    static void wake(std::atomic<uint32_t>& wakeups, std::atomic<uint32_t>& sleeping) {
+        if (sleeping.load()) {
+            wakeups.fetch_add(1);
+            futexWake(&wakeups);
+        }
+    }
+
+    // Blocks while the ring is full.
+    void push(const T* values, size_t n) {
+        while (n > 0) {
+            uint32_t h = head.load(std::memory_order_relaxed);
+            await(producerWakeups, producerSleeping, [&] { return h - tail.load(std::memory_order_acquire) < RING_SIZE; });
+            size_t room = RING_SIZE - (h - tail.load(std::memory_order_acquire));
+            size_t count = n < room ? n : room;
+            for (size_t i = 0; i < count; i++) {
+                items[(h + i) % RING_SIZE] = values[i];
+            }
+            head.store(h + count);  // seq_cst: ordered before the flag check
+            wake(consumerWakeups, consumerSleeping);
+            values += count;
+            n -= count;
+        }
+    }
+
+    // Blocks while the ring is empty; 0 once it is closed and drained.
+    size_t pop(T* values, size_t max) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        await(consumerWakeups, consumerSleeping, [&] { return head.load(std::memory_order_acquire) != t || closed.load(); });
+        size_t available = head.load(std::memory_order_acquire) - t;
+        size_t count = available < max ? available : max;
+        for (size_t i = 0; i < count; i++) {
+            values[i] = items[(t + i) % RING_SIZE];
+        }
+        tail.store(t + count);
+        wake(producerWakeups, producerSleeping);
+        return count;
+    }
+
+    // No more pushes; the consumer drains what is left and then sees 0.
+    void close() {
+        closed.store(1);
+        wake(consumerWakeups, consumerSleeping);
+    }
+};
+
+struct SalaryRevision {
+    double salary;
+    double revisedSalary;
+};
+
+struct Payroll {
+    SpscRing<double> salaries;                // client -> server
+    SpscRing<SalaryRevision> revisedSalaries; // server -> client
 };
 
-void client(int& shmid) { //child 1
-    Payroll* payroll = (Payroll*)shmat(shmid, nullptr, 0);   
-    std::cout << "Number of salaries:"; std::cin >> payroll->size;
-    std::cout << "Enter salaries one by one:" << std::endl;
-    
-    for(int I = 0; I < payroll->size; I++) {
-        std::cin >> payroll->salaries[I];
+// Prints (or, for generated salaries, totals) what comes back while the
+// client keeps sending, so neither ring can fill up and stall the stream.
+void receiveRevisions(Payroll* payroll, bool quiet) {
+    SalaryRevision batch[RING_BATCH];
+    size_t count = 0;
+    double total = 0;
+    size_t n;
+    while ((n = payroll->revisedSalaries.pop(batch, RING_BATCH)) > 0) {
+        for (size_t I = 0; I < n; I++) {
+            if (!quiet) {
+                std::cout << batch[I].salary << " is hiked as "
+                          << batch[I].revisedSalary << std::endl;
+            }
+            total += batch[I].revisedSalary;
+        }
+        count += n;
     }
-    payroll->status = 1;
-    while(2 != payroll->status) { } // wait till payroll is processed
+    std::cout << count << " salaries processed, revised total " << total << std::endl;
+}
+
+void client(int& shmid, long generated) { //child 1
+    Payroll* payroll = (Payroll*)shmat(shmid, nullptr, 0);
+    std::thread receiver(receiveRevisions, payroll, generated > 0);
 
-    std::cout << "Processed Salaries" << std::endl;
-    for(int I = 0; I < payroll->size; I++) {
-        std::cout << payroll->salaries[I] << " is hiked as " 
-                  << payroll->revisedSalaries[I] << std::endl;
+    if (generated > 0) {
+        auto start = std::chrono::steady_clock::now();
+        double batch[RING_BATCH];
+        for (long sent = 0; sent < generated; ) {
+            size_t n = 0;
+            for (; n < RING_BATCH && sent < generated; n++, sent++) {
+                batch[n] = 1000 + sent % 1000;
+            }
+            payroll->salaries.push(batch, n);
+        }
+        payroll->salaries.close();
+        receiver.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "round trip of " << generated << " salaries in " << seconds << "s = "
+                  << (long)(generated / seconds) << " salaries/s" << std::endl;
+    } else {
+        std::cout << "Enter salaries one by one (Ctrl+D to finish):" << std::endl;
+        double salary;
+        while (std::cin >> salary) {
+            payroll->salaries.push(&salary, 1);
+        }
+        payroll->salaries.close();
+        receiver.join();
     }
-    payroll->status = 3;
     shmdt(payroll);
 }
 
 void server(int& shmid) { //child 2
-    Payroll* payroll = (Payroll*)shmat(shmid, nullptr, 0); 
-    for(int I = 0; I < payroll->size; I++) {
-        payroll->revisedSalaries[I] = payroll->salaries[I] * 1.1;
+    Payroll* payroll = (Payroll*)shmat(shmid, nullptr, 0);
+    double salaries[RING_BATCH];
+    SalaryRevision revisions[RING_BATCH];
+    size_t n;
+    while ((n = payroll->salaries.pop(salaries, RING_BATCH)) > 0) {
+        for (size_t I = 0; I < n; I++) {
+            revisions[I].salary = salaries[I];
+            revisions[I].revisedSalary = salaries[I] * HIKE;
+        }
+        payroll->revisedSalaries.push(revisions, n);
+    }
+    payroll->revisedSalaries.close();
+    shmdt(payroll);
+}
+
+// Header of the segment for the K-worker mode; salaries[size] and then
+// revisedSalaries[size] follow it. Workers claim WORK_CHUNK salaries at a
+// time from `next`, so a slow worker just ends up with fewer chunks.
+struct SharedPayroll {
+    alignas(64) std::atomic<size_t> next;   // first salary not yet claimed
+    alignas(64) size_t size;
+
+    double* salaries() { return (double*)(this + 1); }
+    double* revisedSalaries() { return salaries() + size; }
+};
+
+// Four salaries per step in a vector register (GCC/Clang vector
+// extension; SSE2 on any x86-64, AVX when built with -mavx).
+typedef double double4 __attribute__((vector_size(32)));
+
+void hikeSalaries(const double* salaries, double* revisedSalaries, size_t n) {
+    const double4 hike = { HIKE, HIKE, HIKE, HIKE };
+    size_t I = 0;
+    for (; I + 4 <= n; I += 4) {
+        double4 lanes;
+        memcpy(&lanes, salaries + I, sizeof(lanes));
+        lanes *= hike;
+        memcpy(revisedSalaries + I, &lanes, sizeof(lanes));
+    }
+    for (; I < n; I++) {
+        revisedSalaries[I] = salaries[I] * HIKE;
+    }
+}
+
+void revisionWorker(int& shmid) { //child k
+    SharedPayroll* payroll = (SharedPayroll*)shmat(shmid, nullptr, 0);
+    size_t size = payroll->size;
+    size_t begin;
+    while ((begin = payroll->next.fetch_add(WORK_CHUNK, std::memory_order_relaxed)) < size) {
+        size_t n = size - begin < WORK_CHUNK ? size - begin : WORK_CHUNK;
+        hikeSalaries(payroll->salaries() + begin, payroll->revisedSalaries() + begin, n);
+    }
+    shmdt(payroll);
+}
+
+int reviseWithWorkers(int workers, size_t size) {
+    int shmid = shmget(IPC_PRIVATE, sizeof(SharedPayroll) + 2 * size * sizeof(double), 0666 | IPC_CREAT);
+    if (shmid < 0) {
+        perror("shmget");
+        return 1;
+    }
+    SharedPayroll* payroll = (SharedPayroll*)shmat(shmid, nullptr, 0);
+    payroll->next = 0;
+    payroll->size = size;
+    for (size_t I = 0; I < size; I++) {
+        payroll->salaries()[I] = 1000 + I % 1000;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < workers; k++) {
+        if (0 == fork()) {
+            revisionWorker(shmid);
+            _exit(0);
+        }
+    }
+    for (int k = 0; k < workers; k++) {
+        wait(nullptr);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t wrong = 0;
+    for (size_t I = 0; I < size; I++) {
+        wrong += payroll->revisedSalaries()[I] != payroll->salaries()[I] * HIKE;
     }
-    payroll->status = 2;
+    std::cout << size << " salaries revised by " << workers << " workers in " << seconds
+              << "s = " << (long)(size / seconds) << " salaries/s, wrong: " << wrong << std::endl;
+
     shmdt(payroll);
+    shmctl(shmid, IPC_RMID, nullptr);
+    return wrong == 0 ? 0 : 1;
 }
 
-int main() {    
-    int shmid = shmget(SHM_KEY, sizeof(Payroll), 0666 | IPC_CREAT);   
-    Payroll* payroll = (Payroll*)shmat(shmid, nullptr, 0); 
-    payroll->status = 0;
+int main(int argc, char* argv[]) {
+    if (argc == 4 && strcmp(argv[1], "workers") == 0) {
+        int workers = atoi(argv[2]);
+        long size = atol(argv[3]);
+        return reviseWithWorkers(workers > 0 ? workers : 1, size > 0 ? size : 0);
+    }
+    long generated = argc > 1 ? atol(argv[1]) : 0;
+    // a private segment: the ring layout is bigger than the old Payroll
+    // and must not collide with a stale segment of the old layout
+    int shmid = shmget(IPC_PRIVATE, sizeof(Payroll), 0666 | IPC_CREAT);
+    if (shmid < 0) {
+        perror("shmget");
+        return 1;
+    }
+    Payroll* payroll = (Payroll*)shmat(shmid, nullptr, 0);
+    payroll->salaries.init();
+    payroll->revisedSalaries.init();
     pid_t pid = -1;
     {   //child 1
         pid = fork();
-        if(0 == pid) {            
-            client(shmid);               
+        if(0 == pid) {
+            client(shmid, generated);
             return 0;
         }
     }
@@ -64,16 +320,16 @@ int main() {
     {   //child 2
         pid = fork();
         if(0 == pid) {
-            while(1 != payroll->status) { } // wait till salaries read
             server(shmid);
-            while(3 != payroll->status) { } // wait till processed salaries read   
-            shmctl(shmid, IPC_RMID, nullptr);
             return 0;
         }
     }
 
-    // no parent process
+    // parent: wait for both, then release the segment
     wait(nullptr);
-    
+    wait(nullptr);
+    shmdt(payroll);
+    shmctl(shmid, IPC_RMID, nullptr);
+
     return 0;
-}
\ No newline at end of file
+}
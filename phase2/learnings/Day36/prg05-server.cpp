@@ -3,23 +3,42 @@
 #include <netinet/in.h>
 #include <unistd.h>
 #include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/epoll.h>
+
+#include <thread>
+#include <chrono>
+#include <vector>
 
 #define PORT 8080
 #define BUFFER_SIZE 1024
+#define MAX_EVENTS 64
+#define ACCEPT_BACKOFF_MS 10
 
-void run_server() {
-    int server_fd, new_socket;
+// Listening socket on PORT. With reuse_port every listener thread binds its
+// own socket to the same port and the kernel balances connections among them.
+int open_listener(int backlog, bool reuse_port) {
+    int server_fd;
     struct sockaddr_in address;
-    int addrlen = sizeof(address);
-    char buffer[BUFFER_SIZE] = {0};
-    const char* response = "Hello from server";
 
     // Create socket
-    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
+    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
         perror("Socket failed");
         exit(EXIT_FAILURE);
     }
 
+    // SO_REUSEADDR lets a restarted server bind while old connections sit in TIME_WAIT
+    int opt = 1;
+    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (reuse_port && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("SO_REUSEPORT failed");
+        close(server_fd);
+        exit(EXIT_FAILURE);
+    }
+
     // Bind socket to port
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
@@ -31,11 +50,35 @@ void run_server() {
     }
 
     // Listen for connections
-    if (listen(server_fd, 3) < 0) {
+    if (listen(server_fd, backlog) < 0) {
         perror("Listen failed");
         close(server_fd);
         exit(EXIT_FAILURE);
     }
+    return server_fd;
+}
+
+void serve_client(int new_socket) {
+    char buffer[BUFFER_SIZE] = {0};
+    const char* response = "Hello from server";
+
+    // Read data from client
+    read(new_socket, buffer, BUFFER_SIZE - 1);
+    std::cout << "Received from client: " << buffer << std::endl;
+
+    // Send response to client
+    send(new_socket, response, strlen(response), 0);
+    std::cout << "Response sent to client" << std::endl;
+
+    close(new_socket);
+}
+
+void run_server() {
+    int server_fd, new_socket;
+    struct sockaddr_in address;
+    int addrlen = sizeof(address);
+
+    server_fd = open_listener(3, false);
 
     std::cout << "Server is listening on port " << PORT << std::endl;
 
@@ -46,20 +89,104 @@ void run_server() {
         exit(EXIT_FAILURE);
     }
 
-    // Read data from client
-    read(new_socket, buffer, BUFFER_SIZE);
-    std::cout << "Received from client: " << buffer << std::endl;
-
-    // Send response to client
-    send(new_socket, response, strlen(response), 0);
-    std::cout << "Response sent to client" << std::endl;
+    serve_client(new_socket);
 
     // Close sockets
-    close(new_socket);
     close(server_fd);
 }
 
-int main() {
+// Accept every connection waiting on the (non-blocking) listener and watch
+// it on epoll_fd. On EMFILE/ENFILE or another failure, back off briefly
+// instead of retrying at once: the listener stays readable (level-triggered),
+// so the next epoll_wait tries again.
+void accept_all(int epoll_fd, int server_fd) {
+    while (true) {
+        int new_socket = accept4(server_fd, nullptr, nullptr, SOCK_NONBLOCK);
+        if (new_socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("Accept failed");
+                std::this_thread::sleep_for(std::chrono::milliseconds(ACCEPT_BACKOFF_MS));
+            }
+            return;
+        }
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = new_socket;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, new_socket, &event) < 0) {
+            perror("epoll_ctl failed");
+            close(new_socket);
+        }
+    }
+}
+
+// One listener thread: its own SO_REUSEPORT socket and epoll loop, which
+// accepts connections and serves each once its request has arrived, so a
+// slow client does not hold up the others on this listener.
+void run_listener(int backlog) {
+    int server_fd = open_listener(backlog, true);
+    fcntl(server_fd, F_SETFL, fcntl(server_fd, F_GETFL) | O_NONBLOCK);
+
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0) {
+        perror("epoll_create1 failed");
+        exit(EXIT_FAILURE);
+    }
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = server_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &event) < 0) {
+        perror("epoll_ctl failed");
+        exit(EXIT_FAILURE);
+    }
+
+    epoll_event events[MAX_EVENTS];
+    while (true) {
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait failed");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.fd == server_fd) {
+                accept_all(epoll_fd, server_fd);
+            } else {
+                serve_client(events[i].data.fd);    // closing it also drops it from epoll_fd
+            }
+        }
+    }
+}
+
+// Serve forever from `listeners` threads, each accepting on its own socket.
+void run_reuseport_server(int listeners, int backlog) {
+    std::cout << "Server is listening on port " << PORT << " with " << listeners
+              << " SO_REUSEPORT listeners, backlog " << backlog << std::endl;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < listeners; i++) {
+        threads.emplace_back(run_listener, backlog);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// usage: ./a.out                                one client, then exit
+//        ./a.out reuseport [listeners] [backlog]
+int main(int argc, char* argv[]) {
+    // A client that hangs up before the response must not kill the server.
+    signal(SIGPIPE, SIG_IGN);
+
+    if (argc > 1 && strcmp(argv[1], "reuseport") == 0) {
+        int listeners = argc > 2 ? atoi(argv[2]) : (int)std::thread::hardware_concurrency();
+        int backlog = argc > 3 ? atoi(argv[3]) : SOMAXCONN;
+        run_reuseport_server(listeners > 0 ? listeners : 1, backlog > 0 ? backlog : SOMAXCONN);
+        return 0;
+    }
     run_server();
     return 0;
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 
 #include <unistd.h>
 #include <cstring>
+#include <algorithm>
 
 #include <string>
 #include <sstream>
@@ -12,17 +13,297 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <endian.h>
+#include <csignal>
+
+#include <cstdint>
+#include <stdexcept>
+
 #include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <iomanip>
+#include <vector>
 
 #define BUFFER_SIZE 1024
-#define MAX_CONNS 5
+#define MAX_EVENTS 256
+#define POOL_WORKERS 8
+#define ACCEPT_QUEUE_SIZE 64
+#define STATS_SECONDS 5
 
-void server(int port);
+void server(int port, int workers, size_t queueCapacity, bool rejectWhenFull, int backlog);
 void serveClient(int);
 void client(std::string server_ip, int port);
-void requestServer(int&);
+bool requestServer(int&);
+int connectServer(std::string server_ip, int port);
+void clientLoad(std::string server_ip, int port, long requests, long depth, long batch);
+void bench(std::string server_ip, int port, int connections, int seconds, long rate, int threads);
+void serverEpoll(int port, int workers);
+void serverReusePort(int port, int listeners, int backlog);
+void epollWorker(int epoll_fd, int listen_fd);
+int openListener(int port, int backlog, bool reusePort);
+
+// Wire format: every message is one frame
+//     [payload length: uint16, big-endian][type: uint8][payload]
+// whose payload is a run of int64 values, big-endian. A sum request is
+// 19 bytes and its answer 11, against 2048 and 1024 for the old padded
+// buffers. Frames carry their own length, so they can be sent back to
+// back and split or merged by TCP in any way.
+// A connection stays open for any number of requests; the server answers
+// them in the order they arrive, so a client may pipeline without waiting.
+enum FrameType : uint8_t {
+    SUM_REQUEST = 1,        // payload: first, second
+    SUM_RESPONSE = 2,       // payload: sum
+    SUM_BATCH_REQUEST = 3,  // payload: first1, second1, first2, second2, ...
+    SUM_BATCH_RESPONSE = 4, // payload: sum1, sum2, ...
+    VECTOR_SUM_REQUEST = 5, // payload: n values, answered by one SUM_RESPONSE
+};
+
+#define FRAME_HEADER_SIZE 3
+#define MAX_FRAME_PAYLOAD 65535
+#define MAX_BATCH_PAIRS (MAX_FRAME_PAYLOAD / (2 * sizeof(int64_t)))
+#define MAX_PENDING_OUT (1 << 20)
+#define ACCEPT_BACKOFF_MS 10
+
+void appendFrame(std::string& out, uint8_t type, const long* values, size_t count) {
+    size_t length = count * sizeof(int64_t);
+    if (length > MAX_FRAME_PAYLOAD) {
+        throw std::length_error("frame payload too long");
+    }
+    char header[FRAME_HEADER_SIZE] = { (char)(length >> 8), (char)(length & 0xff), (char)type };
+    out.append(header, FRAME_HEADER_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t wire = htobe64((uint64_t)values[i]);
+        out.append((const char*)&wire, sizeof(wire));
+    }
+}
+
+long frameValue(const char* payload, size_t index) {
+    uint64_t wire;
+    memcpy(&wire, payload + index * sizeof(wire), sizeof(wire));
+    return (long)be64toh(wire);
+}
+
+// Incremental frame parser. feed() hands every complete frame in the new
+// bytes to onFrame(type, payload, length) straight from the caller's
+// buffer, and keeps only an incomplete tail for the next call.
+// onFrame returns false for a frame it will not accept; feed() then stops
+// and returns false so the caller can drop the connection.
+class FrameParser {
+    private:
+        std::string pending;
+
+        template<class OnFrame>
+        static size_t parse_(const char* data, size_t n, OnFrame& onFrame, bool& wellFormed) {
+            size_t at = 0;
+            while (n - at >= FRAME_HEADER_SIZE) {
+                size_t length = ((unsigned char)data[at] << 8) | (unsigned char)data[at + 1];
+                if (n - at < FRAME_HEADER_SIZE + length) {
+                    break;
+                }
+                if (length % sizeof(int64_t) != 0
+                        || !onFrame((uint8_t)data[at + 2], data + at + FRAME_HEADER_SIZE, length)) {
+                    wellFormed = false;
+                    break;
+                }
+                at += FRAME_HEADER_SIZE + length;
+            }
+            return at;
+        }
+    public:
+        template<class OnFrame>
+        bool feed(const char* data, size_t n, OnFrame onFrame) {
+            bool wellFormed = true;
+            if (pending.empty()) {
+                size_t used = parse_(data, n, onFrame, wellFormed);
+                pending.assign(data + used, n - used);
+            } else {
+                pending.append(data, n);
+                size_t used = parse_(pending.data(), pending.size(), onFrame, wellFormed);
+                pending.erase(0, used);
+            }
+            if (pending.empty()) {
+                std::string().swap(pending);    // idle connections hold no buffer
+            }
+            return wellFormed;
+        }
+};
 
-void server(int port) {
+bool writeAll(int fd, const char* data, size_t n) {
+    while (n > 0) {
+        ssize_t written = write(fd, data, n);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        n -= written;
+    }
+    return true;
+}
+
+// Append the answer to one request frame; false for a frame a client
+// should not send.
+bool answerFrame(uint8_t type, const char* payload, size_t length, std::string& out) {
+    size_t count = length / sizeof(int64_t);
+    switch (type) {
+    case SUM_REQUEST: {
+        if (count != 2) {
+            return false;
+        }
+        long sum = frameValue(payload, 0) + frameValue(payload, 1);
+        appendFrame(out, SUM_RESPONSE, &sum, 1);
+        return true;
+    }
+    case SUM_BATCH_REQUEST: {
+        if (count % 2 != 0) {
+            return false;
+        }
+        long sums[MAX_BATCH_PAIRS];
+        for (size_t i = 0; i < count / 2; i++) {
+            sums[i] = frameValue(payload, 2 * i) + frameValue(payload, 2 * i + 1);
+        }
+        appendFrame(out, SUM_BATCH_RESPONSE, sums, count / 2);
+        return true;
+    }
+    case VECTOR_SUM_REQUEST: {
+        long sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            sum += frameValue(payload, i);
+        }
+        appendFrame(out, SUM_RESPONSE, &sum, 1);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+// accept() failed with EMFILE/ENFILE: the process (or system) is out of
+// descriptors. accept() reserves the descriptor before it looks at the
+// backlog, so it fails this way even when nobody is waiting; wait up to
+// wait_ms for a connection, and return false if none arrives. A waiting
+// connection would make an immediate retry spin (and an edge-triggered
+// listener would not report it again), so spend a spare descriptor kept
+// for this to accept and close it (the client sees a close instead of a
+// hang), then take the spare back. Without a spare, back off briefly.
+static std::mutex spareMtx;
+static int spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+bool shedConnection(int listen_fd, int wait_ms) {
+    pollfd pending { listen_fd, POLLIN, 0 };
+    if (poll(&pending, 1, wait_ms) <= 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(spareMtx);
+    if (spare_fd >= 0) {
+        close(spare_fd);
+        int client_socket_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_socket_fd >= 0) {
+            close(client_socket_fd);
+        }
+        spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (client_socket_fd >= 0) {
+            return true;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ACCEPT_BACKOFF_MS));
+    return true;
+}
+
+// Accepted sockets waiting for a pool worker. When it is full the acceptor
+// either closes the new connection (reject) or stops accepting until a
+// worker frees a place (delay), leaving further clients in the kernel's
+// listen backlog.
+class AcceptQueue {
+    private:
+        std::mutex mtx;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::deque<int> fds;
+        size_t capacity;
+    public:
+        std::atomic<long> accepted { 0 };
+        std::atomic<long> rejected { 0 };
+        std::atomic<long> delayed { 0 };
+        std::atomic<size_t> maxDepth { 0 };
+
+        explicit AcceptQueue(size_t capacity) : capacity(capacity) {}
+
+        size_t depth() {
+            std::lock_guard<std::mutex> lock(mtx);
+            return fds.size();
+        }
+
+        // false when the queue is full and rejectWhenFull is set
+        bool push(int fd, bool rejectWhenFull) {
+            std::unique_lock<std::mutex> lock(mtx);
+            accepted++;
+            if (fds.size() >= capacity) {
+                if (rejectWhenFull) {
+                    rejected++;
+                    return false;
+                }
+                delayed++;
+                notFull.wait(lock, [this] { return fds.size() < capacity; });
+            }
+            fds.push_back(fd);
+            if (fds.size() > maxDepth) {
+                maxDepth = fds.size();
+            }
+            lock.unlock();
+            notEmpty.notify_one();
+            return true;
+        }
+
+        int pop() {
+            std::unique_lock<std::mutex> lock(mtx);
+            notEmpty.wait(lock, [this] { return !fds.empty(); });
+            int fd = fds.front();
+            fds.pop_front();
+            lock.unlock();
+            notFull.notify_one();
+            return fd;
+        }
+};
+
+void poolWorker(AcceptQueue* queue) {
+    while (true) {
+        serveClient(queue->pop());
+    }
+}
+
+// Print the queue counters every STATS_SECONDS while there is traffic.
+void reportStats(AcceptQueue* queue) {
+    long lastAccepted = 0;
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(STATS_SECONDS));
+        if (queue->accepted == lastAccepted) {
+            continue;
+        }
+        lastAccepted = queue->accepted;
+        std::cout << "stats: accepted " << lastAccepted
+                  << ", queued " << queue->depth()
+                  << " (max " << queue->maxDepth << ")"
+                  << ", rejected " << queue->rejected
+                  << ", delayed " << queue->delayed << std::endl;
+    }
+}
+
+// Threaded server: a fixed pool of workers, each serving one connection at
+// a time, fed by a bounded AcceptQueue. Thread creation is off the accept
+// path and concurrency is capped at the pool size.
+void server(int port, int workers, size_t queueCapacity, bool rejectWhenFull, int backlog) {
     int server_socket_fd;
     // Create socket
     if ((server_socket_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
@@ -43,13 +324,21 @@ void server(int port) {
         exit(EXIT_FAILURE);
     }
 
-    // Listen for connections
-    if (listen(server_socket_fd, MAX_CONNS) < 0) { 
+    // Listen for connections; in delay mode waiting clients queue up here
+    if (listen(server_socket_fd, backlog) < 0) { 
         perror("Listen failed");
         close(server_socket_fd);
         exit(EXIT_FAILURE);
     }
 
+    AcceptQueue queue(queueCapacity);
+    for (int i = 0; i < workers; i++) {
+        std::thread thrWorker(poolWorker, &queue);
+        thrWorker.detach();
+    }
+    std::thread thrStats(reportStats, &queue);
+    thrStats.detach();
+
     // Accept a connection
     while(true)
     {
@@ -57,15 +346,22 @@ void server(int port) {
         sockaddr_in client_address;
         int addrlen = sizeof(client_address);
         if ((client_socket_fd = accept(server_socket_fd, (sockaddr*)&client_address, (socklen_t*)&addrlen)) < 0) { //blocked
+            if (errno == EMFILE || errno == ENFILE) {
+                shedConnection(server_socket_fd, ACCEPT_BACKOFF_MS);
+                continue;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
             perror("Accept failed");
             close(server_socket_fd);
             exit(EXIT_FAILURE);
         }
 
-        //serve the client
-        //serveClient(client_socket_fd);
-        std::thread thrServe(serveClient, client_socket_fd);
-        thrServe.detach();//thrServe.join();//
+        //serve the client: hand it to the pool
+        if (!queue.push(client_socket_fd, rejectWhenFull)) {
+            close(client_socket_fd);
+        }
     }
     // Close server socket
     close(server_socket_fd);
@@ -73,31 +369,271 @@ void server(int port) {
 
 void serveClient(int client_socket_fd) {
     char buffer[BUFFER_SIZE];
+    FrameParser parser;
+    std::string response;
+    long served = 0;
 
-    long first;
-    long second;
-    // receive first number
-    read(client_socket_fd, buffer, BUFFER_SIZE);
-    memcpy((void*)&first, (void*)buffer, sizeof(long));
-    // receive second number 
-    read(client_socket_fd, buffer, BUFFER_SIZE);
-    memcpy((void*)&second,(void*)buffer, sizeof(long));
-    // process numbers
-    long sum = first + second;
-    std::cout << "process:" << first << " + " 
-                            << second << " = " 
-                            << sum << " done." << std::endl;
-
-    // send response
-    memcpy((void*)buffer, (void*)&sum, sizeof(long));
-    write(client_socket_fd, buffer, BUFFER_SIZE);
-    std::cout << "\tresponse sent to client" << std::endl;
+    // answer requests until the client closes; everything that arrived in
+    // one read is answered with one write
+    while (true) {
+        ssize_t n = read(client_socket_fd, buffer, BUFFER_SIZE);
+        if (n <= 0) {
+            break;
+        }
+        bool wellFormed = parser.feed(buffer, n, [&](uint8_t type, const char* payload, size_t length) {
+            served++;
+            return answerFrame(type, payload, length, response);
+        });
+        if (!response.empty() && !writeAll(client_socket_fd, response.data(), response.size())) {
+            break;
+        }
+        response.clear();
+        if (!wellFormed) {
+            break;
+        }
+    }
+    std::cout << "process: " << served << " requests done." << std::endl;
 
     // release client // Close client socket
     close(client_socket_fd);
 }
 
-void client(std::string server_ip, int port) {
+// Per-connection state for the epoll server: the parser keeps only a
+// partial frame between reads, so an idle connection costs a few dozen bytes.
+struct EpollConnection {
+    int fd;
+    FrameParser parser;
+    std::string out;    // response frames not yet written
+    size_t sent;        // bytes of out already written
+    bool closing;       // client finished sending; close once out is flushed
+};
+
+// Write out until it is flushed or the socket is full.
+// Returns false on a broken connection.
+static bool flushConnection(EpollConnection* conn) {
+    while (conn->sent < conn->out.size()) {
+        ssize_t n = write(conn->fd, conn->out.data() + conn->sent, conn->out.size() - conn->sent);
+        if (n > 0) {
+            conn->sent += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;    // wait for the next EPOLLOUT
+        } else {
+            return false;
+        }
+    }
+    conn->out.clear();
+    conn->sent = 0;
+    return true;
+}
+
+// Drain the socket until EAGAIN (edge-triggered), answering every frame.
+// Reading pauses while MAX_PENDING_OUT answers are unsent, so a client
+// that pipelines without reading cannot grow the buffer without bound.
+// Returns false when the connection is finished.
+static bool serviceConnection(EpollConnection* conn, char* scratch) {
+    while (true) {
+        if (!flushConnection(conn)) {
+            return false;
+        }
+        size_t unsent = conn->out.size() - conn->sent;
+        if (conn->closing) {
+            return unsent > 0;
+        }
+        if (unsent >= MAX_PENDING_OUT) {
+            return true;    // resume reading on EPOLLOUT
+        }
+        ssize_t n = read(conn->fd, scratch, BUFFER_SIZE);
+        if (n > 0) {
+            bool wellFormed = conn->parser.feed(scratch, n, [conn](uint8_t type, const char* payload, size_t length) {
+                return answerFrame(type, payload, length, conn->out);
+            });
+            if (!wellFormed) {
+                return false;
+            }
+        } else if (n == 0) {
+            conn->closing = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return flushConnection(conn);   // wait for the next EPOLLIN
+        } else {
+            return false;
+        }
+    }
+}
+
+// Watch fd on epoll_fd for edge-triggered input and output as a new connection.
+static void addConnection(int epoll_fd, int client_socket_fd) {
+    EpollConnection* conn = new EpollConnection { client_socket_fd, FrameParser(), std::string(), 0, false };
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = conn;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket_fd, &event) < 0) {
+        perror("epoll_ctl failed");
+        close(client_socket_fd);
+        delete conn;
+    }
+}
+
+// Accept until the (non-blocking) listener's queue is empty.
+static void acceptAll(int epoll_fd, int listen_fd) {
+    while (true) {
+        int client_socket_fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+        if (client_socket_fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE) {
+                if (!shedConnection(listen_fd, 0)) {
+                    return;     // the next connection raises a new edge
+                }
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("Accept failed");
+            }
+            return;
+        }
+        addConnection(epoll_fd, client_socket_fd);
+    }
+}
+
+// Event loop over the connections in epoll_fd. With listen_fd >= 0 the
+// loop also owns that listener (registered with a null data.ptr) and
+// accepts its own connections.
+void epollWorker(int epoll_fd, int listen_fd) {
+    if (listen_fd >= 0) {
+        epoll_event event {};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) < 0) {
+            perror("epoll_ctl failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    epoll_event events[MAX_EVENTS];
+    char scratch[BUFFER_SIZE];
+    while (true) {
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait failed");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < ready; i++) {
+            EpollConnection* conn = (EpollConnection*)events[i].data.ptr;
+            if (conn == nullptr) {
+                acceptAll(epoll_fd, listen_fd);
+                continue;
+            }
+            bool keep = !(events[i].events & EPOLLERR) && serviceConnection(conn, scratch);
+            if (!keep) {
+                close(conn->fd);    // also drops it from the epoll set
+                delete conn;
+            }
+        }
+    }
+}
+
+// Bound and listening socket on port. With reusePort several sockets may
+// bind the same port and the kernel spreads new connections across them.
+int openListener(int port, int backlog, bool reusePort) {
+    int server_socket_fd;
+    if ((server_socket_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+        perror("Socket failed");
+        exit(EXIT_FAILURE);
+    }
+
+    int reuse = 1;
+    setsockopt(server_socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (reusePort && setsockopt(server_socket_fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+        perror("SO_REUSEPORT failed");
+        close(server_socket_fd);
+        exit(EXIT_FAILURE);
+    }
+
+    sockaddr_in address;
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+
+    if (bind(server_socket_fd, (sockaddr*)&address, sizeof(address)) < 0) {
+        perror("Bind failed");
+        close(server_socket_fd);
+        exit(EXIT_FAILURE);
+    }
+
+    if (listen(server_socket_fd, backlog) < 0) {
+        perror("Listen failed");
+        close(server_socket_fd);
+        exit(EXIT_FAILURE);
+    }
+    return server_socket_fd;
+}
+
+// Event-loop server: one acceptor plus a fixed number of worker threads,
+// each with its own epoll set of non-blocking, edge-triggered sockets.
+// Thread count stays constant no matter how many clients are connected.
+void serverEpoll(int port, int workers) {
+    int server_socket_fd = openListener(port, SOMAXCONN, false);
+
+    std::vector<int> epoll_fds;
+    for (int i = 0; i < workers; i++) {
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd < 0) {
+            perror("epoll_create1 failed");
+            exit(EXIT_FAILURE);
+        }
+        epoll_fds.push_back(epoll_fd);
+        std::thread thrWorker(epollWorker, epoll_fd, -1);
+        thrWorker.detach();
+    }
+
+    // Hand connections to the workers round-robin.
+    for (size_t next = 0; ; next = (next + 1) % epoll_fds.size()) {
+        int client_socket_fd = accept4(server_socket_fd, nullptr, nullptr, SOCK_NONBLOCK);
+        if (client_socket_fd < 0) {
+            if (errno == EMFILE || errno == ENFILE) {
+                shedConnection(server_socket_fd, ACCEPT_BACKOFF_MS);
+                continue;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            perror("Accept failed");
+            close(server_socket_fd);
+            exit(EXIT_FAILURE);
+        }
+        addConnection(epoll_fds[next], client_socket_fd);
+    }
+}
+
+// Multi-acceptor server: `listeners` threads, each with its own
+// SO_REUSEPORT listener (queue length `backlog`) accepted and served by
+// its own epoll loop, so no single accept() thread is a bottleneck.
+void serverReusePort(int port, int listeners, int backlog) {
+    std::vector<std::thread> loops;
+    for (int i = 0; i < listeners; i++) {
+        int listen_fd = openListener(port, backlog, true);
+        fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK);
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd < 0) {
+            perror("epoll_create1 failed");
+            exit(EXIT_FAILURE);
+        }
+        loops.emplace_back(epollWorker, epoll_fd, listen_fd);
+    }
+    for (std::thread& loop : loops) {
+        loop.join();
+    }
+}
+
+int connectServer(std::string server_ip, int port) {
     int client_socket_fd = 0;  
     // create socket
     if ((client_socket_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
@@ -120,52 +656,474 @@ void client(std::string server_ip, int port) {
         perror("Connection failed");
         exit(EXIT_FAILURE);
     }
+    return client_socket_fd;
+}
+
+void client(std::string server_ip, int port) {
+    int client_socket_fd = connectServer(server_ip, port);
 
-    // request the server 
-    requestServer(client_socket_fd);
+    // request the server, one sum after another on the same connection
+    while (requestServer(client_socket_fd)) {
+    }
 
     // close client socket
     close(client_socket_fd);
 }
 
-void requestServer(int& client_socket_fd) {
+// Ask for one sum; false once input or the connection ends.
+bool requestServer(int& client_socket_fd) {
     char buffer[BUFFER_SIZE];
     
     long first;
     long second;
     std::cout << "First Number:"; std::cin >> first;
     std::cout << "Second Number:"; std::cin >> second;
+    if (!std::cin) {
+        std::cout << std::endl;
+        return false;
+    }
     // send numbers
-    memcpy((void*)buffer,(void*)&first,sizeof(long));
-    write(client_socket_fd, buffer, BUFFER_SIZE);
-
-    memcpy((void*)buffer,(void*)&second,sizeof(long));
-    write(client_socket_fd, buffer, BUFFER_SIZE);
+    std::string request;
+    long numbers[] = { first, second };
+    appendFrame(request, SUM_REQUEST, numbers, 2);
+    if (!writeAll(client_socket_fd, request.data(), request.size())) {
+        perror("Send failed");
+        return false;
+    }
     // receive response
-   
-    read(client_socket_fd, buffer, BUFFER_SIZE);
-    //
+    FrameParser parser;
+    bool received = false;
     long sum {};
-    memcpy((void*)&sum, (void*)buffer, sizeof(long));
+    while (!received) {
+        ssize_t n = read(client_socket_fd, buffer, BUFFER_SIZE);
+        if (n <= 0) {
+            std::cout << "Server closed the connection" << std::endl;
+            return false;
+        }
+        bool wellFormed = parser.feed(buffer, n, [&](uint8_t type, const char* payload, size_t length) {
+            if (type != SUM_RESPONSE || length != sizeof(int64_t)) {
+                return false;
+            }
+            sum = frameValue(payload, 0);
+            received = true;
+            return true;
+        });
+        if (!wellFormed) {
+            std::cout << "Malformed answer from server" << std::endl;
+            return false;   // the caller closes the connection
+        }
+    }
     std::cout << "So," << first << " + " 
                             << second << " = " 
                             << sum << std::endl;
     std::cout << "I am thankful to my sum calculator server!!!" << std::endl;
+    return true;
+}
+
+// Send `requests` sums over one connection, keeping up to `depth` frames
+// in flight; with batch > 1 each frame is a SUM_BATCH_REQUEST of `batch`
+// pairs. Every answer is checked against the expected sum.
+void clientLoad(std::string server_ip, int port, long requests, long depth, long batch) {
+    int client_socket_fd = connectServer(server_ip, port);
+    char buffer[BUFFER_SIZE];
+    FrameParser parser;
+    std::string request;
+    std::vector<long> numbers;
+    long sent = 0;      // sums requested
+    long answered = 0;  // sums answered
+    long wrong = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (answered < requests) {
+        // top up the pipeline
+        request.clear();
+        while (sent < requests && (sent - answered) / batch < depth) {
+            long pairs = std::min(batch, requests - sent);
+            numbers.clear();
+            for (long i = 0; i < pairs; i++) {
+                numbers.push_back(sent + i);
+                numbers.push_back(1);
+            }
+            appendFrame(request, batch > 1 ? SUM_BATCH_REQUEST : SUM_REQUEST, numbers.data(), numbers.size());
+            sent += pairs;
+        }
+        if (!request.empty() && !writeAll(client_socket_fd, request.data(), request.size())) {
+            perror("Send failed");
+            break;
+        }
+
+        ssize_t n = read(client_socket_fd, buffer, BUFFER_SIZE);
+        if (n <= 0) {
+            std::cout << "Server closed the connection" << std::endl;
+            break;
+        }
+        bool wellFormed = parser.feed(buffer, n, [&](uint8_t type, const char* payload, size_t length) {
+            if (type != SUM_RESPONSE && type != SUM_BATCH_RESPONSE) {
+                return false;
+            }
+            for (size_t i = 0; i < length / sizeof(int64_t); i++, answered++) {
+                wrong += frameValue(payload, i) != answered + 1;
+            }
+            return true;
+        });
+        if (!wellFormed) {
+            std::cout << "Unexpected response frame" << std::endl;
+            break;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << answered << " sums in " << seconds << "s = "
+              << (long)(answered / seconds) << " sums/s, wrong: " << wrong << std::endl;
+    close(client_socket_fd);
+}
+
+// Latency histogram: a bucket per power of two, split into 32 linear
+// sub-buckets, so every recorded value keeps ~3% precision in fixed space.
+class LatencyHistogram {
+    private:
+        std::vector<long> counts = std::vector<long>(64 * 32);
+        long total = 0;
+        long maxValue = 0;
+
+        static size_t index_(long value) {
+            if (value < 32) {
+                return value;
+            }
+            int msb = 63 - __builtin_clzl(value);
+            return (msb - 4) * 32 + ((value >> (msb - 5)) & 31);
+        }
+        // largest value that lands in bucket i
+        static long highest_(size_t i) {
+            if (i < 32) {
+                return i;
+            }
+            return ((long)(32 + i % 32 + 1) << (i / 32 - 1)) - 1;
+        }
+    public:
+        void record(long value) {
+            value = std::max(0L, value);
+            counts[index_(value)]++;
+            total++;
+            maxValue = std::max(maxValue, value);
+        }
+
+        void merge(const LatencyHistogram& other) {
+            for (size_t i = 0; i < counts.size(); i++) {
+                counts[i] += other.counts[i];
+            }
+            total += other.total;
+            maxValue = std::max(maxValue, other.maxValue);
+        }
+
+        long count() const { return total; }
+        long max() const { return maxValue; }
+
+        long percentile(double q) const {
+            long target = std::max(1L, (long)(q * total + 0.5));
+            long seen = 0;
+            for (size_t i = 0; i < counts.size(); i++) {
+                seen += counts[i];
+                if (seen >= target) {
+                    return std::min(highest_(i), maxValue);
+                }
+            }
+            return maxValue;
+        }
+};
+
+static long nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct InFlight {
+    long intended;  // when the request was due (open loop) or sent (closed loop)
+    long expected;  // the sum the server should answer
+};
+
+struct BenchConnection {
+    int fd;
+    FrameParser parser;
+    std::string out;
+    size_t sent;
+    std::deque<InFlight> inFlight;
+    long nextSend;  // open loop: when the next request is due
+    long seq;
+    bool dead;      // dropped from the epoll set; nothing more is sent
+};
+
+struct BenchResult {
+    LatencyHistogram latency;
+    long sent = 0;          // requests due before the end of the run
+    long answered = 0;      // answered before the end
+    long unanswered = 0;    // still pending at the end, recorded as waiting until then
+    long errors = 0;
+};
+
+static void queueRequest(BenchConnection& conn, long intended) {
+    long numbers[] = { conn.seq, (long)conn.fd };
+    appendFrame(conn.out, SUM_REQUEST, numbers, 2);
+    conn.inFlight.push_back({ intended, conn.seq + conn.fd });
+    conn.seq++;
+}
+
+// Stop using a broken connection; whatever it still had in flight will
+// never be answered, so those requests (at least one) count as errors.
+static void dropBench(int epoll_fd, BenchConnection& conn, BenchResult* result) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn.fd, nullptr);
+    conn.dead = true;
+    result->errors += std::max<size_t>(1, conn.inFlight.size());
+    conn.inFlight.clear();
+    conn.out.clear();
+    conn.sent = 0;
+}
+
+static bool flushBench(BenchConnection& conn) {
+    while (conn.sent < conn.out.size()) {
+        ssize_t n = write(conn.fd, conn.out.data() + conn.sent, conn.out.size() - conn.sent);
+        if (n > 0) {
+            conn.sent += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    conn.out.clear();
+    conn.sent = 0;
+    return true;
+}
+
+// One load thread: `count` connections on its own epoll set until `end`.
+// Closed loop (interval 0): each connection sends its next request as soon
+// as the previous answer arrives. Open loop: each connection's requests
+// are due every `interval` ns whether or not answers have come back, and
+// latency runs from when a request was due, not when it went out, so a
+// stalled server is charged for the requests it held up (coordinated
+// omission correction); one still unanswered at `end` is recorded as
+// having waited until then. A timerfd in the epoll set wakes the loop when
+// the next request is due (or at `end`), so requests go out within
+// microseconds of schedule rather than epoll_wait's millisecond timeout;
+// any delay left is part of the latency too.
+void benchWorker(std::string server_ip, int port, int count, long interval,
+                 long start, long end, BenchResult* result) {
+    int epoll_fd = epoll_create1(0);
+    std::vector<BenchConnection> conns(count);
+    for (int i = 0; i < count; i++) {
+        BenchConnection& conn = conns[i];
+        conn.fd = connectServer(server_ip, port);
+        fcntl(conn.fd, F_SETFL, fcntl(conn.fd, F_GETFL) | O_NONBLOCK);
+        conn.sent = 0;
+        conn.seq = 0;
+        conn.dead = false;
+        // stagger the open-loop schedules across the interval
+        conn.nextSend = start + (interval / count) * i;
+        epoll_event event {};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        event.data.ptr = &conn;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn.fd, &event);
+    }
+    // steady_clock is CLOCK_MONOTONIC, so nowNs() values arm it directly
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (timer_fd < 0) {
+        perror("timerfd_create failed");
+        exit(EXIT_FAILURE);
+    }
+    epoll_event timerEvent {};
+    timerEvent.events = EPOLLIN;
+    timerEvent.data.ptr = nullptr;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &timerEvent);
+
+    while (nowNs() < start) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    if (interval == 0) {
+        for (BenchConnection& conn : conns) {
+            queueRequest(conn, nowNs());
+            if (!flushBench(conn)) {
+                dropBench(epoll_fd, conn, result);
+            }
+        }
+    }
+
+    epoll_event events[MAX_EVENTS];
+    char buffer[BUFFER_SIZE];
+    long now = nowNs();
+    while (now < end) {
+        long deadline = end;
+        if (interval > 0) {
+            for (BenchConnection& conn : conns) {
+                if (conn.dead) {
+                    continue;
+                }
+                bool due = false;
+                while (conn.nextSend <= now) {
+                    queueRequest(conn, conn.nextSend);
+                    conn.nextSend += interval;
+                    due = true;
+                }
+                if (due && !flushBench(conn)) {
+                    dropBench(epoll_fd, conn, result);
+                    continue;
+                }
+                deadline = std::min(deadline, conn.nextSend);
+            }
+        }
+        itimerspec alarm {};
+        alarm.it_value.tv_sec = deadline / 1000000000L;
+        alarm.it_value.tv_nsec = deadline % 1000000000L;
+        timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &alarm, nullptr);
+
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.ptr == nullptr) {
+                uint64_t expirations;
+                read(timer_fd, &expirations, sizeof(expirations));
+                continue;
+            }
+            BenchConnection& conn = *(BenchConnection*)events[i].data.ptr;
+            if (!flushBench(conn)) {
+                dropBench(epoll_fd, conn, result);
+                continue;
+            }
+            while (!conn.dead) {
+                ssize_t n = read(conn.fd, buffer, BUFFER_SIZE);
+                if (n <= 0) {
+                    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                        dropBench(epoll_fd, conn, result);
+                    }
+                    break;
+                }
+                long received = nowNs();
+                bool wellFormed = conn.parser.feed(buffer, n, [&](uint8_t type, const char* payload, size_t length) {
+                    if (type != SUM_RESPONSE || length != sizeof(int64_t) || conn.inFlight.empty()) {
+                        result->errors++;
+                        return false;
+                    }
+                    InFlight request = conn.inFlight.front();
+                    conn.inFlight.pop_front();
+                    if (frameValue(payload, 0) != request.expected) {
+                        result->errors++;
+                    }
+                    if (received <= end) {
+                        result->latency.record(received - request.intended);
+                        result->answered++;
+                    } else {
+                        result->latency.record(end - request.intended);
+                        result->unanswered++;
+                    }
+                    if (interval == 0 && received < end) {
+                        queueRequest(conn, received);
+                    }
+                    return true;
+                });
+                if (!wellFormed) {
+                    dropBench(epoll_fd, conn, result);
+                }
+            }
+            if (interval == 0 && !conn.dead && !flushBench(conn)) {
+                dropBench(epoll_fd, conn, result);
+            }
+        }
+        now = nowNs();
+    }
+
+    // A request the server is still sitting on has waited at least until
+    // now; leaving it out would hide exactly the stalls being measured.
+    for (BenchConnection& conn : conns) {
+        result->sent += conn.seq;
+        for (const InFlight& request : conn.inFlight) {
+            result->latency.record(end - request.intended);
+            result->unanswered++;
+        }
+        close(conn.fd);
+    }
+    close(timer_fd);
+    close(epoll_fd);
+}
+
+static std::string formatNs(long ns) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    if (ns >= 1000000) {
+        text << ns / 1e6 << "ms";
+    } else {
+        text << ns / 1e3 << "us";
+    }
+    return text.str();
+}
+
+// Load generator: `connections` spread over `threads` epoll threads for
+// `seconds`. rate 0 runs closed loop at full speed; rate > 0 runs open
+// loop at that many requests per second in total.
+void bench(std::string server_ip, int port, int connections, int seconds, long rate, int threads) {
+    threads = std::min(threads, connections);
+    long interval = rate > 0 ? (long)(1e9 * connections / rate) : 0;
+    long start = nowNs() + 200000000L + 1000000L * connections / 10;   // time to connect
+    long end = start + seconds * 1000000000L;
+
+    std::vector<BenchResult> results(threads);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        int count = connections / threads + (i < connections % threads ? 1 : 0);
+        workers.emplace_back(benchWorker, server_ip, port, count, interval, start, end, &results[i]);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    BenchResult total;
+    for (BenchResult& result : results) {
+        total.latency.merge(result.latency);
+        total.sent += result.sent;
+        total.answered += result.answered;
+        total.unanswered += result.unanswered;
+        total.errors += result.errors;
+    }
+    const LatencyHistogram& latency = total.latency;
+    std::cout << (rate > 0 ? "open loop" : "closed loop") << ", " << connections << " connections, "
+              << threads << " threads, " << seconds << "s" << std::endl;
+    std::cout << "requests: " << total.sent << " sent, " << total.answered << " answered ("
+              << total.answered / std::max(1, seconds) << " req/s), " << total.unanswered
+              << " unanswered at end, errors: " << total.errors << std::endl;
+    if (latency.count() > 0) {
+        std::cout << "latency: p50 " << formatNs(latency.percentile(0.50))
+                  << ", p99 " << formatNs(latency.percentile(0.99))
+                  << ", p999 " << formatNs(latency.percentile(0.999))
+                  << ", max " << formatNs(latency.max()) << std::endl;
+    }
 }
 
 int main(int argc, char* argv[]) {
+    // A peer that closes before reading its answers must cost one
+    // connection (write fails with EPIPE), not kill the whole process.
+    signal(SIGPIPE, SIG_IGN);
+
     if(argc <= 1) {
-        std::cout << "usage:\n\t./sumCalculatorApp.out server 8080" << std::endl;
+        std::cout << "usage:\n\t./sumCalculatorApp.out server 8080 [workers] [queue] [reject|delay] [backlog]" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out server-epoll 8080 4" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out server-reuseport 8080 [listeners] [backlog]" << std::endl;
         std::cout << "\t./sumCalculatorApp.out client 127.0.0.1 8080" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out client-load 127.0.0.1 8080 <requests> <depth> <batch>" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out bench 127.0.0.1 8080 <connections> <seconds> [rate, 0 = max] [threads]" << std::endl;
         return EXIT_FAILURE;
     }
 
     if(!(
        (strcmp(argv[1], "client") == 0 && argc == 4) || 
-       (strcmp(argv[1], "server") == 0 && argc == 3)
+       (strcmp(argv[1], "client-load") == 0 && argc == 7) || 
+       (strcmp(argv[1], "bench") == 0 && argc >= 6 && argc <= 8) || 
+       (strcmp(argv[1], "server") == 0 && argc >= 3 && argc <= 7) ||
+       (strcmp(argv[1], "server-epoll") == 0 && argc == 4) ||
+       (strcmp(argv[1], "server-reuseport") == 0 && argc >= 3 && argc <= 5)
        )) {
-        std::cout << "usage:\n\t./sumCalculatorApp.out server 8080" << std::endl;
+        std::cout << "usage:\n\t./sumCalculatorApp.out server 8080 [workers] [queue] [reject|delay] [backlog]" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out server-epoll 8080 4" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out server-reuseport 8080 [listeners] [backlog]" << std::endl;
         std::cout << "\t./sumCalculatorApp.out client 127.0.0.1 8080" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out client-load 127.0.0.1 8080 <requests> <depth> <batch>" << std::endl;
+        std::cout << "\t./sumCalculatorApp.out bench 127.0.0.1 8080 <connections> <seconds> [rate, 0 = max] [threads]" << std::endl;
         return EXIT_FAILURE;
     }
 
@@ -173,9 +1131,37 @@ int main(int argc, char* argv[]) {
         std::cout << "Client [to server `" << argv[2] << ":" << argv[3] << "`]" << std::endl;      
         client(argv[2], atoi(argv[3]));  
     }
+    if(strcmp(argv[1], "client-load") == 0) {
+        std::cout << "Client load [to server `" << argv[2] << ":" << argv[3] << "`]" << std::endl;
+        long batch = std::min(std::max(1L, atol(argv[6])), (long)MAX_BATCH_PAIRS);
+        clientLoad(argv[2], atoi(argv[3]), atol(argv[4]), std::max(1L, atol(argv[5])), batch);
+    }
+    if(strcmp(argv[1], "bench") == 0) {
+        std::cout << "Bench [to server `" << argv[2] << ":" << argv[3] << "`]" << std::endl;
+        int threads = argc > 7 ? atoi(argv[7]) : (int)std::thread::hardware_concurrency();
+        bench(argv[2], atoi(argv[3]), std::max(1, atoi(argv[4])), std::max(1, atoi(argv[5])),
+              argc > 6 ? atol(argv[6]) : 0, std::max(1, threads));
+    }
     if(strcmp(argv[1], "server") == 0) {
-        std::cout << "Server [port:`" << argv[2] << "`]" <<std::endl;
-        server(atoi(argv[2]));
+        int workers = argc > 3 ? std::max(1, atoi(argv[3])) : POOL_WORKERS;
+        size_t queueCapacity = argc > 4 ? std::max(1, atoi(argv[4])) : ACCEPT_QUEUE_SIZE;
+        bool rejectWhenFull = argc <= 5 || strcmp(argv[5], "delay") != 0;
+        int backlog = argc > 6 ? std::max(1, atoi(argv[6])) : SOMAXCONN;
+        std::cout << "Server [port:`" << argv[2] << "`, workers:`" << workers
+                  << "`, queue:`" << queueCapacity << "`, when full:`"
+                  << (rejectWhenFull ? "reject" : "delay") << "`, backlog:`" << backlog << "`]" <<std::endl;
+        server(atoi(argv[2]), workers, queueCapacity, rejectWhenFull, backlog);
+    }
+    if(strcmp(argv[1], "server-epoll") == 0) {
+        std::cout << "Server [port:`" << argv[2] << "`, epoll workers:`" << argv[3] << "`]" <<std::endl;
+        serverEpoll(atoi(argv[2]), std::max(1, atoi(argv[3])));
+    }
+    if(strcmp(argv[1], "server-reuseport") == 0) {
+        int listeners = argc > 3 ? std::max(1, atoi(argv[3])) : std::max(1u, std::thread::hardware_concurrency());
+        int backlog = argc > 4 ? std::max(1, atoi(argv[4])) : SOMAXCONN;
+        std::cout << "Server [port:`" << argv[2] << "`, SO_REUSEPORT listeners:`" << listeners
+                  << "`, backlog:`" << backlog << "`]" <<std::endl;
+        serverReusePort(atoi(argv[2]), listeners, backlog);
     }
     
     return EXIT_SUCCESS;
@@ -0,0 +1,33 @@
+#pragma once
+#include "type.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+class IdIndexEntry {
+    public:
+        identity_t id;
+        long long offset;   // byte offset of the record in the data file
+};
+
+// id -> record offset, sorted by id. Loaded once from a sidecar file
+// and written back on every change, so ReadById is a binary search + one seek.
+// New ids go through an append stream kept open between calls, so a create
+// costs one write to the index, not an open, a write and a close.
+class IdIndex {
+    private:
+        std::string index_file_name;
+        std::vector<IdIndexEntry> entries;
+        std::ofstream appendOutput;     // closed by Save_, reopened on the next append
+        void Save_();
+        void AppendToFile_(const IdIndexEntry* newEntries, size_t count);
+    public:
+        IdIndex(std::string index_file_name);
+        size_t Count() { return entries.size(); }
+        void Load();
+        void Clear();
+        bool Find(identity_t id, long long& offset);
+        void Insert(identity_t id, long long offset);
+        void InsertMany(std::vector<IdIndexEntry>& newEntries);
+        void Erase(identity_t id);
+};
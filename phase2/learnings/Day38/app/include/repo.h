@@ -6,6 +6,7 @@ template<class T>
 class ICreatable {
     public: 
         virtual void Create(T& entity) = 0;
+        virtual void CreateMany(std::vector<T>& entities) = 0;  // ids assigned in order
         virtual ~ICreatable() { }
 };
 
@@ -1,2 +1,2 @@
 #pragma once
-using identity_t = short int;
\ No newline at end of file
+using identity_t = int;   // was short: wrapped after 32767 vendors
\ No newline at end of file
@@ -22,6 +22,32 @@ class FileVendor {
         short int ratings;
 };
 
+// First bytes of vendor.dat: next id and record count, so Create needs
+// neither a scan nor a reopen to number a new vendor.
+class FileVendorHeader {
+    public:
+        char magic[8];
+        identity_t nextId;
+        long long recordCount;
+};
+
+// Layouts of vendor.dat from when ids were short: a bare LegacyFileVendor
+// array, later with a LegacyFileVendorHeader ("VENDOR1") in front.
+// VendorFileRepo migrates both on open.
+class LegacyFileVendor {
+    public:
+        short int id;
+        char name[255];
+        short int ratings;
+};
+
+class LegacyFileVendorHeader {
+    public:
+        char magic[8];
+        short int nextId;
+        long long recordCount;
+};
+
 class VendorConverter { 
     public: 
         static FileVendor ConvertVendorToFileVendor(Vendor& vendor);
@@ -2,11 +2,23 @@
 #include "ivendor_repo.h"
 #include "vendor.h"
 #include "type.h"
+#include "id_index.h"
+#include <fstream>
 
 class VendorFileRepo : public IVendorRepo
 {
+    private:
+        std::fstream file;          // vendor.dat, open for the repo's lifetime
+        FileVendorHeader header;    // cached copy of the on-disk header
+        IdIndex index;
+        void Open_();
+        void MigrateLegacyFile_();
+        void WriteHeader_();
+        void SyncIndex_();
     public: 
+        VendorFileRepo();
         void Create(Vendor& entity) override;
+        void CreateMany(std::vector<Vendor>& entities) override;
         Vendor ReadById(identity_t id) override;
         std::vector<Vendor> ReadAll() override;
 };
\ No newline at end of file
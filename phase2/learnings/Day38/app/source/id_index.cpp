@@ -0,0 +1,117 @@
+#include "./../include/id_index.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+static bool LessById(const IdIndexEntry& entry, identity_t id) {
+    return entry.id < id;
+}
+
+IdIndex::IdIndex(std::string index_file_name) : index_file_name(index_file_name) { }
+
+void IdIndex::Load() {
+    entries.clear();
+
+    std::ifstream input(index_file_name, std::ios::binary | std::ios::ate);
+    if (!input) {
+        return; // no index yet
+    }
+
+    size_t fileSize = input.tellg();
+    entries.resize(fileSize / sizeof(IdIndexEntry));
+    input.seekg(0, std::ios::beg);
+    input.read((char*)entries.data(), entries.size() * sizeof(IdIndexEntry));
+    input.close();
+}
+
+void IdIndex::Save_() {
+    appendOutput.close();
+    std::ofstream output(index_file_name, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Failed to open index file for writing.");
+    }
+    output.write((char*)entries.data(), entries.size() * sizeof(IdIndexEntry));
+    output.close();
+}
+
+void IdIndex::AppendToFile_(const IdIndexEntry* newEntries, size_t count) {
+    if (!appendOutput.is_open()) {
+        appendOutput.clear();
+        appendOutput.open(index_file_name, std::ios::binary | std::ios::app);
+    }
+    appendOutput.write((const char*)newEntries, count * sizeof(IdIndexEntry));
+    appendOutput.flush();
+    if (!appendOutput) {
+        appendOutput.close();
+        throw std::runtime_error("Failed to write index file.");
+    }
+}
+
+void IdIndex::Clear() {
+    entries.clear();
+    Save_();
+}
+
+bool IdIndex::Find(identity_t id, long long& offset) {
+    auto it = std::lower_bound(entries.begin(), entries.end(), id, LessById);
+    if (it == entries.end() || it->id != id) {
+        return false;
+    }
+    offset = it->offset;
+    return true;
+}
+
+void IdIndex::Insert(identity_t id, long long offset) {
+    IdIndexEntry entry { id, offset };
+
+    // ids are handed out in increasing order: append, no rewrite
+    if (entries.empty() || entries.back().id < id) {
+        entries.push_back(entry);
+        AppendToFile_(&entry, 1);
+        return;
+    }
+
+    auto it = std::lower_bound(entries.begin(), entries.end(), id, LessById);
+    if (it != entries.end() && it->id == id) {
+        it->offset = offset;
+    } else {
+        entries.insert(it, entry);
+    }
+    Save_();
+}
+
+void IdIndex::InsertMany(std::vector<IdIndexEntry>& newEntries) {
+    if (newEntries.empty()) {
+        return;
+    }
+
+    // fresh ids from one batch: append them all with a single write
+    bool appendOnly = entries.empty() || entries.back().id < newEntries.front().id;
+    for (size_t i = 1; appendOnly && i < newEntries.size(); i++) {
+        appendOnly = newEntries[i - 1].id < newEntries[i].id;
+    }
+
+    if (appendOnly) {
+        entries.insert(entries.end(), newEntries.begin(), newEntries.end());
+        AppendToFile_(newEntries.data(), newEntries.size());
+        return;
+    }
+
+    for (auto& entry : newEntries) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), entry.id, LessById);
+        if (it != entries.end() && it->id == entry.id) {
+            it->offset = entry.offset;
+        } else {
+            entries.insert(it, entry);
+        }
+    }
+    Save_();
+}
+
+void IdIndex::Erase(identity_t id) {
+    auto it = std::lower_bound(entries.begin(), entries.end(), id, LessById);
+    if (it != entries.end() && it->id == id) {
+        entries.erase(it);
+        Save_();
+    }
+}
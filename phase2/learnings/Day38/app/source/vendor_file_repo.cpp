@@ -1,96 +1,231 @@
 #include "./../include/vendor_file_repo.h"
 #include <iostream>
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <limits>
 static const std::string repo_file_name = "vendor.dat";
+static const std::string index_file_name = "vendor.idx";
+static const char header_magic[8] = "VENDOR2";          // int ids
+static const char legacy_header_magic[8] = "VENDOR1";   // short ids
 static void CreateFile_() { 
     std::ofstream output(repo_file_name, std::ios::binary | std::ios::app);
     output.close();
 }
-static identity_t GetLastId_() {
+static long long OffsetOf_(long long recordNo) {
+    return sizeof(FileVendorHeader) + recordNo * sizeof(FileVendor);
+}
+// Refuse ids past the end of identity_t rather than wrap into ones in use.
+static void CheckIdsLeft_(identity_t nextId, size_t wanted) {
+    if (wanted > (size_t)(std::numeric_limits<identity_t>::max() - nextId)) {
+        throw std::runtime_error("No vendor ids left.");
+    }
+}
+
+VendorFileRepo::VendorFileRepo() : index(index_file_name) {
+    Open_();
+    SyncIndex_();
+}
+
+void VendorFileRepo::Open_() {
     CreateFile_(); //create file if not exists
 
-    std::fstream file(repo_file_name, std::ios::binary | std::ios::in);
-    if (!file) {
+    std::ifstream input(repo_file_name, std::ios::binary | std::ios::ate);
+    if (!input) {
         throw std::runtime_error("Failed to open file for reading.");
     }
+    size_t fileSize = input.tellg();
+    input.seekg(0, std::ios::beg);
+    bool hasHeader = fileSize >= sizeof(FileVendorHeader)
+        && input.read((char*)&header, sizeof(FileVendorHeader))
+        && memcmp(header.magic, header_magic, sizeof(header_magic)) == 0;
+    input.close();
 
-    // Get the size of the file
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
+    if (!hasHeader) {
+        MigrateLegacyFile_();
+    }
 
-    // Check if the file is empty
-    if (fileSize == 0) {
-        file.close();
-        return 0; // No records exist
+    file.open(repo_file_name, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for reading/writing.");
     }
+}
 
-    // Calculate the position of the last record
-    size_t lastRecordPos = fileSize - sizeof(FileVendor);
+// vendor.dat from before ids were widened: a bare LegacyFileVendor array
+// (or empty), or one behind a VENDOR1 header. Rewrite it in the current
+// layout behind a fresh header.
+void VendorFileRepo::MigrateLegacyFile_() {
+    std::ifstream input(repo_file_name, std::ios::binary | std::ios::ate);
+    if (!input) {
+        throw std::runtime_error("Failed to open file for reading.");
+    }
+    size_t fileSize = input.tellg();
+    input.seekg(0, std::ios::beg);
+
+    LegacyFileVendorHeader legacyHeader;
+    long long recordCount = fileSize / sizeof(LegacyFileVendor);
+    if (fileSize >= sizeof(LegacyFileVendorHeader)
+            && input.read((char*)&legacyHeader, sizeof(LegacyFileVendorHeader))
+            && memcmp(legacyHeader.magic, legacy_header_magic, sizeof(legacy_header_magic)) == 0) {
+        recordCount = std::min<long long>(legacyHeader.recordCount,
+            (fileSize - sizeof(LegacyFileVendorHeader)) / sizeof(LegacyFileVendor));
+    } else {
+        input.clear();
+        input.seekg(0, std::ios::beg);
+    }
 
-    // Seek to the last record
-    file.seekg(lastRecordPos, std::ios::beg);
+    std::vector<FileVendor> fileVendors;
+    fileVendors.reserve(recordCount);
+    LegacyFileVendor legacy;
+    identity_t nextId = 1;
+    for (long long recordNo = 0; recordNo < recordCount; recordNo++) {
+        input.read((char*)&legacy, sizeof(LegacyFileVendor));
+        FileVendor fileVendor;
+        memset(&fileVendor, 0, sizeof(FileVendor));
+        fileVendor.id = legacy.id;
+        memcpy(fileVendor.name, legacy.name, sizeof(fileVendor.name));
+        fileVendor.ratings = legacy.ratings;
+        fileVendors.push_back(fileVendor);
+        nextId = std::max(nextId, fileVendor.id + 1);
+    }
+    input.close();
 
-    // Read the last record
-    FileVendor fileVendor;
-    file.read((char*)&fileVendor, sizeof(FileVendor));
+    memset(&header, 0, sizeof(FileVendorHeader));
+    memcpy(header.magic, header_magic, sizeof(header_magic));
+    header.nextId = nextId;
+    header.recordCount = fileVendors.size();
 
-    file.close();
-    return fileVendor.id;
+    std::string temp_file_name = repo_file_name + ".tmp";
+    std::ofstream output(temp_file_name, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Failed to open file for writing.");
+    }
+    output.write((char*)&header, sizeof(FileVendorHeader));
+    output.write((char*)fileVendors.data(), fileVendors.size() * sizeof(FileVendor));
+    output.close();
+
+    std::rename(temp_file_name.c_str(), repo_file_name.c_str());
+    index.Clear(); // offsets and entry layout changed
 }
 
+// The header is one small write at offset 0, issued after the record it counts.
+void VendorFileRepo::WriteHeader_() {
+    file.clear();
+    file.seekp(0, std::ios::beg);
+    file.write((char*)&header, sizeof(FileVendorHeader));
+    file.flush();
+}
 
+// Load the index; rebuild it from vendor.dat if it is missing or out of step.
+void VendorFileRepo::SyncIndex_() {
+    index.Load();
+    if ((long long)index.Count() == header.recordCount) {
+        return;
+    }
 
-void VendorFileRepo::Create(Vendor& entity) { 
-    identity_t lastId = GetLastId_();
-    std::ofstream output(repo_file_name, std::ios::binary | std::ios::app);
-    if (!output) {
-        throw std::runtime_error("Failed to open file for writing.");
+    // collect every entry, then write the index once
+    std::vector<IdIndexEntry> entries;
+    entries.reserve(header.recordCount);
+    file.clear();
+    file.seekg(OffsetOf_(0), std::ios::beg);
+    FileVendor fileVendor;
+    for (long long recordNo = 0; recordNo < header.recordCount; recordNo++) {
+        file.read((char*)&fileVendor, sizeof(FileVendor));
+        entries.push_back(IdIndexEntry { fileVendor.id, OffsetOf_(recordNo) });
     }
+    std::sort(entries.begin(), entries.end(), [](const IdIndexEntry& a, const IdIndexEntry& b) {
+        return a.id < b.id;
+    });
+    index.Clear();
+    index.InsertMany(entries);
+}
 
+void VendorFileRepo::Create(Vendor& entity) { 
+    CheckIdsLeft_(header.nextId, 1);
     FileVendor fileAccount = VendorConverter::ConvertVendorToFileVendor(entity);
-    fileAccount.id = lastId + 1; // new Id
-    output.write((char*)&fileAccount, sizeof(fileAccount));
-    output.close();
+    fileAccount.id = header.nextId; // new Id
+    long long offset = OffsetOf_(header.recordCount);
+
+    file.clear();
+    file.seekp(offset, std::ios::beg);
+    file.write((char*)&fileAccount, sizeof(fileAccount));
+    if (!file) {
+        throw std::runtime_error("Failed to write vendor.");
+    }
+
+    header.nextId++;
+    header.recordCount++;
+    WriteHeader_();
+
+    entity.SetId(fileAccount.id);
+    index.Insert(fileAccount.id, offset);
 }
 
-Vendor VendorFileRepo::ReadById(identity_t id) {
-    CreateFile_(); //create file if not exists
+// One seek and one write for the whole batch, then one header write.
+void VendorFileRepo::CreateMany(std::vector<Vendor>& entities) {
+    if (entities.empty()) {
+        return;
+    }
+    CheckIdsLeft_(header.nextId, entities.size());
+
+    std::vector<FileVendor> fileVendors;
+    std::vector<IdIndexEntry> indexEntries;
+    fileVendors.reserve(entities.size());
+    indexEntries.reserve(entities.size());
+
+    long long offset = OffsetOf_(header.recordCount);
+    identity_t nextId = header.nextId;
+    for (auto& entity : entities) {
+        FileVendor fileVendor = VendorConverter::ConvertVendorToFileVendor(entity);
+        fileVendor.id = nextId++;
+        entity.SetId(fileVendor.id);
+        fileVendors.push_back(fileVendor);
+        indexEntries.push_back(IdIndexEntry { fileVendor.id, offset });
+        offset += sizeof(FileVendor);
+    }
 
-    std::ifstream input(repo_file_name, std::ios::binary);
-    if (!input) {
-        throw std::runtime_error("Failed to open file for reading.");
+    file.clear();
+    file.seekp(OffsetOf_(header.recordCount), std::ios::beg);
+    file.write((char*)fileVendors.data(), fileVendors.size() * sizeof(FileVendor));
+    if (!file) {
+        throw std::runtime_error("Failed to write vendors.");
     }
 
-    FileVendor fileVendor;
+    header.nextId = nextId;
+    header.recordCount += fileVendors.size();
+    WriteHeader_();
+
+    index.InsertMany(indexEntries);
+}
 
-    while (input.read((char*)&fileVendor, sizeof(FileVendor))) {
-        if (fileVendor.id == id) {
-            input.close();
-            return VendorConverter::ConvertFileVendorToVendor(fileVendor);
-        }
+Vendor VendorFileRepo::ReadById(identity_t id) {
+    long long offset;
+    if (!index.Find(id, offset)) {
+        throw std::runtime_error("Vendor with given ID not found.");
     }
 
-    input.close();
-    throw std::runtime_error("Vendor with given ID not found.");
+    FileVendor fileVendor;
+    file.clear();
+    file.seekg(offset, std::ios::beg);
+    file.read((char*)&fileVendor, sizeof(FileVendor));
+
+    return VendorConverter::ConvertFileVendorToVendor(fileVendor);
 }
 
 std::vector<Vendor> VendorFileRepo::ReadAll() {
-    CreateFile_(); //create file if not exists
-    
     std::vector<Vendor> vendors;
+    vendors.reserve(header.recordCount);
 
-    std::ifstream file(repo_file_name, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Failed to open file for reading.");
-    }
+    file.clear();
+    file.seekg(OffsetOf_(0), std::ios::beg);
 
     FileVendor fileVendor;
-
-    while (file.read((char*)&fileVendor, sizeof(FileVendor))) {
+    for (long long recordNo = 0; recordNo < header.recordCount; recordNo++) {
+        file.read((char*)&fileVendor, sizeof(FileVendor));
         auto&& vendor = VendorConverter::ConvertFileVendorToVendor(fileVendor);
         vendors.push_back(vendor);
     }
 
-    file.close();
     return vendors;
-}
\ No newline at end of file
+}
@@ -4,16 +4,22 @@
 //      server: 
 //          request: receives array of doctors
 //          response:sends sum
+//      request = [count: 8 bytes][count doctors], no size limit
 #include <iostream>
 #include <string>
 #include <vector>
 #include <climits>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
 #include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
 
 using identity_t = char[20];//std::string;
 using years_t = short;
-using field_size_t = short;
 
 class Doctor {
     private:
@@ -26,28 +32,92 @@ class Doctor {
         years_t getYearsOfExperience() { return this->yearsOfExperience; }
 };
 
-years_t findSum(std::vector<Doctor>& doctors) {
-    years_t sum = 0;
-    for(auto doctor : doctors) {
-        sum += doctor.getYearsOfExperience();
+using count_t = unsigned long long;   // request header: number of doctors
+using sum_t = long long;                // wide enough for millions of doctors
+
+// Doctors per read on the server; the request streams through this chunk,
+// so the server's memory does not grow with the number of doctors.
+const count_t CHUNK_DOCTORS = 64 * 1024;
+const int PIPE_SIZE = 1 << 20;
+
+sum_t findSum(std::vector<Doctor>& doctors, count_t size) {
+    sum_t sum = 0;
+    for(count_t I = 0; I < size; I++) {
+        sum += doctors[I].getYearsOfExperience();
     }
     return sum;
 }
 
+bool readFully(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = read(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool writeFully(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Hand the pages of data to the pipe instead of copying them into it.
+// The pages must stay untouched until the reader has consumed them;
+// the client only reuses its vector after the server has answered.
+// Falls back to write() where vmsplice is not available.
+bool spliceFully(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        iovec iov { (void*)data, size };
+        ssize_t n = vmsplice(fd, &iov, 1, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == ENOSYS || errno == EINVAL)) {
+            return writeFully(fd, data, size);
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
 void server(int read_pipe_fd, int write_pipe_fd)
 {
-    const int BUFFER_SIZE = 1024;
-    char buffer[BUFFER_SIZE];
-
-    read(read_pipe_fd, buffer, BUFFER_SIZE);
-    field_size_t size;
-    memcpy((char*)&size, buffer, sizeof(field_size_t));
-    std::vector<Doctor> doctors(size, Doctor("",0));
-    memcpy((char*)(doctors.data()), (char*)(buffer + sizeof(field_size_t)),sizeof(Doctor)*size);
-    
-    years_t sum = findSum(doctors); 
-    memcpy(buffer, (char*)(&sum), sizeof(years_t));
-    write(write_pipe_fd, buffer, BUFFER_SIZE);
+    count_t size = 0;
+    sum_t sum = 0;
+    if (readFully(read_pipe_fd, (char*)&size, sizeof(count_t))) {
+        std::vector<Doctor> chunk(std::min(size, CHUNK_DOCTORS), Doctor("",0));
+        for (count_t done = 0; done < size; ) {
+            count_t n = std::min(size - done, CHUNK_DOCTORS);
+            if (!readFully(read_pipe_fd, (char*)chunk.data(), sizeof(Doctor) * n)) {
+                std::cout << "request cut short after " << done << " doctors" << std::endl;
+                break;
+            }
+            sum += findSum(chunk, n);
+            done += n;
+        }
+    }
+    writeFully(write_pipe_fd, (char*)&sum, sizeof(sum_t));
 
     close(read_pipe_fd);
     close(write_pipe_fd);
@@ -55,25 +125,30 @@ void server(int read_pipe_fd, int write_pipe_fd)
 
 void client(std::vector<Doctor>& doctors, int read_pipe_fd, int write_pipe_fd)
 {
-    const int BUFFER_SIZE = 1024;
-    char buffer[BUFFER_SIZE];
+    auto start = std::chrono::steady_clock::now();
 
-    field_size_t size = doctors.size();    
-    memcpy(buffer, (char*)(&size), sizeof(field_size_t));    
-    memcpy(buffer + sizeof(field_size_t), (char*)(doctors.data()), sizeof(Doctor) * size);
-    write(write_pipe_fd, buffer, BUFFER_SIZE);
+    // length header, then the doctors straight from the vector's pages
+    count_t size = doctors.size();
+    writeFully(write_pipe_fd, (char*)&size, sizeof(count_t));
+    spliceFully(write_pipe_fd, (char*)doctors.data(), sizeof(Doctor) * size);
 
-    years_t sum; 
-    read(read_pipe_fd, buffer, BUFFER_SIZE);
-    memcpy((char*)(&sum), buffer, sizeof(years_t));
+    sum_t sum = 0;
+    readFully(read_pipe_fd, (char*)&sum, sizeof(sum_t));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
     close(write_pipe_fd);
     close(read_pipe_fd);
 
     std::cout << "sum = " << sum << std::endl;
+    if (size > 1000) {
+        std::cout << size << " doctors in " << seconds << "s = "
+                  << (long)(size / seconds) << " doctors/s" << std::endl;
+    }
 }
 
-int main() {
+// usage: ./a.out            the five sample doctors
+//        ./a.out 5000000    that many generated doctors
+int main(int argc, char* argv[]) {
     std::vector<Doctor> doctors {        
         Doctor("D001", 5),
         Doctor("D002", 4),
@@ -81,6 +156,14 @@ int main() {
         Doctor("D004", 2),
         Doctor("D005", 1)
     };
+    if (argc > 1) {
+        long count = atol(argv[1]);
+        doctors.clear();
+        doctors.reserve(count > 0 ? count : 0);
+        for (long I = 0; I < count; I++) {
+            doctors.emplace_back("D", (years_t)(I % 40));
+        }
+    }
 
     int client_to_server_fd[2];
     int server_to_client_fd[2];
@@ -90,6 +173,8 @@ int main() {
         std::cout << "pipe error" << std::endl;
         return 1;
     }
+    // fewer, larger transfers; ignored where the limit does not allow it
+    fcntl(client_to_server_fd[1], F_SETPIPE_SZ, PIPE_SIZE);
 
     auto& [server_read_pipe_fd, client_write_pipe_fd] = client_to_server_fd;
     auto& [client_read_pipe_fd, server_write_pipe_fd] = server_to_client_fd;
@@ -23,9 +23,22 @@ class FileDepartment {
         int  id;
         char name[100];
         char description[256];
+        bool deleted;   // tombstone, see RecordFile::Kill
 
         int GetId() const { return id; }
         void SetId(int newId) { id = newId; }
+        bool IsDeleted() const { return deleted; }
+        void MarkDeleted() { deleted = true; }
+};
+
+// FileDepartment as written before the tombstone field: back to back with
+// no header, or after a RecordFileHeader. DepartmentFileRepo migrates such
+// files on open.
+class LegacyFileDepartment {
+    public:
+        int  id;
+        char name[100];
+        char description[256];
 };
 
 class DepartmentConverter { 
@@ -36,6 +49,7 @@ class DepartmentConverter {
             fileDepartment.id = Department.GetId();
             strcpy(fileDepartment.name, Department.GetName().c_str());
             strcpy(fileDepartment.description, Department.GetDescription().c_str());
+            fileDepartment.deleted = false;
             
             return fileDepartment;
         }
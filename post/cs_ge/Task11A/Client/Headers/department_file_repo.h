@@ -5,20 +5,37 @@
 #include <cstring> 
 
 #include "department.h"
+#include "record_file.h"
+#include "id_index.h"
+#include "name_index.h"
 
 class DepartmentFileRepo 
 {
 private:
     std::string repo_file_name = "Department.dat";
-    void CreateFile_();
-    int GetLastId_();
+    std::string id_index_file_name = "Department.idx";
+    std::string name_index_file_name = "Department.nidx";
+    bool migrated = MigrateLegacyFile_();    // before store opens the file
+    RecordFile<FileDepartment> store{repo_file_name};
+    IdIndex id_index{id_index_file_name};
+    NameIndex name_index{name_index_file_name};
+    size_t compact_dead_percent = 25;   // compact once this share of records is deleted
+    void Refresh_();
+    void RebuildIdIndex_();
+    void RebuildNameIndex_();
+    void CompactIfNeeded_();
+    bool MigrateLegacyFile_();
+    static NameIndexEntry MakeNameIndexEntry_(const FileDepartment& fileDepartment, size_t slot);
 public:
     void Create(Department& entity);
+    void CreateMany(std::vector<Department>& entities);
     std::vector<Department> ReadAll();
     //
     std::vector<Department> SearchByName(const std::string& name);
+    std::vector<Department> SearchByNamePrefix(const std::string& prefix);
     Department ReadByName(std::string name);
     Department ReadById(int id);    
     void Update(Department& entity);
     void DeleteByName(const std::string& name);
+    void Compact();
 };
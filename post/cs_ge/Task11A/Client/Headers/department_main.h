@@ -12,6 +12,7 @@ class DepartmentUi {
             std::string& description);
     public:        
         void Create(Department& department);
+        std::string ReadSearchText();
         void Display(std::vector<Department>& departments);
 };
 
@@ -22,6 +23,7 @@ class DepartmentController {
     public:        
         void Create();
         void Display();
+        void Search();
 };
 
 class DepartmentPage {
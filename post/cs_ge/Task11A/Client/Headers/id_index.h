@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "record_file.h"
+
+class IdIndexEntry {
+    public:
+        int id;
+        int slot;           // -1: tombstone, skipped on lookup
+
+        bool IsDeleted() const { return slot < 0; }
+        void MarkDeleted() { slot = -1; }
+};
+
+// Primary key index: id -> record slot, kept sorted by id in a mapped
+// sidecar file so point lookups are a binary search with no loading step.
+// Erase leaves a tombstone in place; the repo rebuilds the index when it
+// compacts the data file, which drops them.
+class IdIndex {
+    private:
+        RecordFile<IdIndexEntry> entries;
+
+        size_t LowerBound_(int id);
+    public:
+        explicit IdIndex(const std::string& fileName);
+
+        void Refresh();
+        size_t Count() const;
+        void Clear();
+
+        bool Find(int id, size_t& slot);
+        void Insert(int id, size_t slot);
+        void InsertMany(std::vector<IdIndexEntry>& newEntries);
+        void Erase(int id);
+};
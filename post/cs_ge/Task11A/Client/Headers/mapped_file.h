@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+// Read/write shared mapping of a whole file.
+// The file (and the mapping) only ever grows, in multiples of chunkSize,
+// so Data() is invalidated by Reserve() and by a Refresh() that returns true.
+class MappedFile {
+    private:
+        int fd = -1;
+        char* data = nullptr;
+        size_t size = 0;
+        size_t chunkSize;
+
+        void Map_(size_t newSize);
+        void Unmap_();
+    public:
+        MappedFile(const std::string& fileName, size_t chunkSize = 1 << 20);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        char* Data() { return data; }
+        const char* Data() const { return data; }
+        size_t Size() const { return size; }
+
+        void Reserve(size_t bytes);
+        bool Refresh();
+        void Sync();
+};
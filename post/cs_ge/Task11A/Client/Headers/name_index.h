@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "record_file.h"
+
+class NameIndexEntry {
+    public:
+        int  id;
+        int  slot;          // -1: tombstone, skipped on lookup
+        char name[100];
+
+        bool IsDeleted() const { return slot < 0; }
+        void MarkDeleted() { slot = -1; }
+};
+
+// Secondary index on FileDepartment::name: (name, id) -> slot in a mapped
+// sidecar. The first SortedCount() entries are sorted and binary searched;
+// Insert appends to a short unsorted tail instead of shifting the file, and
+// the tail is merged in once it reaches TAIL_LIMIT entries. Erase leaves a
+// tombstone; merges and rebuilds drop them.
+// Results come back in (name, id) order: for one name, file order.
+class NameIndex {
+    private:
+        static const size_t TAIL_LIMIT = 1024;
+
+        RecordFile<NameIndexEntry> entries;
+
+        size_t LowerBound_(const char* name, int id);
+        std::vector<NameIndexEntry> LiveSorted_();
+        void Merge_();
+        template<class Match>
+        std::vector<size_t> Find_(const char* key, Match match);
+    public:
+        explicit NameIndex(const std::string& fileName);
+
+        void Refresh();
+        size_t Count() const;
+        void Clear();
+
+        std::vector<size_t> FindExact(const std::string& name);
+        std::vector<size_t> FindPrefix(const std::string& prefix);
+        void Insert(const char* name, int id, size_t slot);
+        void InsertMany(std::vector<NameIndexEntry>& newEntries);
+        void Erase(const char* name, int id);
+};
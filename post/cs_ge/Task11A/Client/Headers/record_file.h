@@ -0,0 +1,160 @@
+#pragma once
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "mapped_file.h"
+
+// Superblock at the start of every record file. It lives in the shared
+// mapping, so every handle on the file sees the same counts without I/O.
+class RecordFileHeader {
+    public:
+        char magic[8];
+        unsigned int recordSize;
+        unsigned int version;
+        unsigned long long count;
+        unsigned long long deadCount;
+        long long nextId;
+        unsigned long long sortedCount;     // sorted indexes: records [0, sortedCount) are in key order
+        char reserved[16];
+};
+static_assert(sizeof(RecordFileHeader) == 64, "RecordFileHeader must stay 64 bytes");
+
+// Fixed-size records of T stored back to back after a RecordFileHeader
+// in a MappedFile that grows in chunks.
+// A record is written before the header count that publishes it, so a
+// crash mid-append leaves the previous count, never a half-written record.
+// Deleting through Kill() only sets the record's tombstone (T::MarkDeleted);
+// Compact() later squeezes the tombstones out in place. The same holds for
+// index files, whose entries carry their own tombstone.
+// References returned by At()/Modify()/Append() are views into the mapping
+// and stay valid only until the next Append() or Refresh().
+template<class T>
+class RecordFile {
+    static_assert(std::is_trivially_copyable<T>::value, "RecordFile needs a plain record type");
+    static_assert(sizeof(RecordFileHeader) % alignof(T) == 0, "records must stay aligned after the header");
+    private:
+        MappedFile file;
+
+        RecordFileHeader* Header_() { return reinterpret_cast<RecordFileHeader*>(file.Data()); }
+        const RecordFileHeader* Header_() const { return reinterpret_cast<const RecordFileHeader*>(file.Data()); }
+        T* Slots_() { return reinterpret_cast<T*>(file.Data() + sizeof(RecordFileHeader)); }
+        static size_t Bytes_(size_t records) { return sizeof(RecordFileHeader) + records * sizeof(T); }
+
+        void Open_(const std::string& fileName) {
+            if (file.Size() == 0) {
+                file.Reserve(sizeof(RecordFileHeader));
+                RecordFileHeader* header = Header_();
+                std::memcpy(header->magic, "RECFILE", 8);
+                header->recordSize = sizeof(T);
+                header->version = 1;
+                header->count = 0;
+                header->deadCount = 0;
+                header->nextId = 1;
+                header->sortedCount = 0;
+                return;
+            }
+            if (file.Size() < sizeof(RecordFileHeader)
+                    || std::memcmp(Header_()->magic, "RECFILE", 8) != 0
+                    || Header_()->recordSize != sizeof(T)) {
+                throw std::runtime_error(fileName + " is not a record file of this layout.");
+            }
+        }
+    public:
+        explicit RecordFile(const std::string& fileName, size_t chunkSize = 1 << 20)
+            : file(fileName, chunkSize) {
+            Open_(fileName);
+        }
+
+        // Pick up growth by another handle on the same file; the header is
+        // shared, so this only remaps when the count outgrew our mapping.
+        void Refresh() {
+            if (file.Size() < Bytes_(Count())) {
+                file.Refresh();
+            }
+        }
+
+        size_t Count() const { return Header_()->count; }
+
+        // Hand out the next id; ids are never reused, even after Compact().
+        int NextId() { return static_cast<int>(Header_()->nextId++); }
+
+        const T& At(size_t slot) { return Slots_()[slot]; }
+        T& Modify(size_t slot) { return Slots_()[slot]; }
+
+        const T* begin() { return Slots_(); }
+        const T* end() { return Slots_() + Count(); }
+
+        T& Append(const T& record) {
+            size_t count = Count();
+            file.Reserve(Bytes_(count + 1));
+            T& slot = Slots_()[count];
+            slot = record;
+            Header_()->count = count + 1;
+            return slot;
+        }
+
+        // One Reserve and one copy for the whole batch, published by a single count update.
+        void AppendMany(const T* records, size_t n) {
+            size_t count = Count();
+            file.Reserve(Bytes_(count + n));
+            std::memcpy(&Slots_()[count], records, n * sizeof(T));
+            Header_()->count = count + n;
+        }
+
+        void Clear() {
+            size_t count = Count();
+            Header_()->count = 0;
+            Header_()->deadCount = 0;
+            Header_()->sortedCount = 0;
+            std::memset(Slots_(), 0, count * sizeof(T));
+        }
+
+        size_t DeadCount() const { return Header_()->deadCount; }
+
+        size_t SortedCount() const { return Header_()->sortedCount; }
+        void SetSortedCount(size_t sorted) { Header_()->sortedCount = sorted; }
+
+        void Kill(size_t slot) {
+            T& record = Slots_()[slot];
+            if (!record.IsDeleted()) {
+                record.MarkDeleted();
+                Header_()->deadCount++;
+            }
+        }
+
+        // Overwrite slot with a live record, undoing its tombstone if it had one.
+        void Revive(size_t slot, const T& record) {
+            if (Slots_()[slot].IsDeleted() && !record.IsDeleted()) {
+                Header_()->deadCount--;
+            }
+            Slots_()[slot] = record;
+        }
+
+        // Move live records down over the tombstones, keeping their order.
+        void Compact() {
+            size_t count = Count();
+            T* slots = Slots_();
+            size_t sorted = Header_()->sortedCount;
+            size_t live = 0;
+            size_t liveSorted = 0;
+            for (size_t slot = 0; slot < count; slot++) {
+                if (!slots[slot].IsDeleted()) {
+                    if (live != slot) {
+                        slots[live] = slots[slot];
+                    }
+                    live++;
+                    if (slot < sorted) {
+                        liveSorted = live;
+                    }
+                }
+            }
+            Header_()->count = live;
+            Header_()->sortedCount = liveSorted;
+            Header_()->deadCount = 0;
+            std::memset(&slots[live], 0, (count - live) * sizeof(T));
+        }
+
+        void Sync() { file.Sync(); }
+};
@@ -1,7 +1,9 @@
-#include <fstream>
 #include <stdexcept>
+#include <fstream>
+#include <algorithm>
 
-#include <cstring> 
+#include <cstdio>
+#include <cstring>
 
 #include <string>
 #include <vector>
@@ -9,208 +11,279 @@
 #include "./../Headers/department_file_repo.h"
 
 //class DepartmentFileRepo
-void DepartmentFileRepo::CreateFile_()
+// Rewrite a Department.dat of the old layout (no header, or records without
+// the tombstone) as a record file of this one. Slots keep their order, but
+// the indexes are dropped so Refresh_ rebuilds them. Returns true if it did.
+bool DepartmentFileRepo::MigrateLegacyFile_()
 {
-    std::ofstream output(repo_file_name, std::ios::binary | std::ios::app);
-    output.close();
-}
+    std::ifstream input(repo_file_name, std::ios::binary | std::ios::ate);
+    if (!input || input.tellg() == 0) {
+        return false;   // new file: RecordFile lays it out
+    }
+    size_t fileSize = static_cast<size_t>(input.tellg());
+    input.seekg(0, std::ios::beg);
+
+    RecordFileHeader header {};
+    size_t recordsStart = 0;
+    if (fileSize >= sizeof(RecordFileHeader)) {
+        input.read((char*)&header, sizeof(RecordFileHeader));
+        if (std::memcmp(header.magic, "RECFILE", 8) == 0) {
+            if (header.recordSize == sizeof(FileDepartment)) {
+                return false;   // current layout
+            }
+            if (header.recordSize != sizeof(LegacyFileDepartment)) {
+                throw std::runtime_error(repo_file_name + " is not a record file of this layout.");
+            }
+            recordsStart = sizeof(RecordFileHeader);
+        }
+    }
+    size_t recordCount;
+    if (recordsStart > 0) {
+        recordCount = std::min<size_t>(header.count, (fileSize - recordsStart) / sizeof(LegacyFileDepartment));
+    } else if (fileSize % sizeof(LegacyFileDepartment) == 0) {
+        recordCount = fileSize / sizeof(LegacyFileDepartment);
+        header = RecordFileHeader {};
+        header.nextId = 1;
+    } else {
+        throw std::runtime_error(repo_file_name + " is not a record file of this layout.");
+    }
+
+    std::vector<FileDepartment> fileDepartments(recordCount);
+    input.clear();
+    input.seekg(recordsStart, std::ios::beg);
+    LegacyFileDepartment legacy;
+    for (FileDepartment& fileDepartment : fileDepartments) {
+        input.read((char*)&legacy, sizeof(LegacyFileDepartment));
+        fileDepartment = FileDepartment {};
+        fileDepartment.id = legacy.id;
+        std::memcpy(fileDepartment.name, legacy.name, sizeof(fileDepartment.name));
+        std::memcpy(fileDepartment.description, legacy.description, sizeof(fileDepartment.description));
+        fileDepartment.deleted = false;
+        header.nextId = std::max<long long>(header.nextId, legacy.id + 1LL);
+    }
+    input.close();
 
-int DepartmentFileRepo::GetLastId_() {
-    CreateFile_(); 
+    std::memcpy(header.magic, "RECFILE", 8);
+    header.recordSize = sizeof(FileDepartment);
+    header.version = 1;
+    header.count = recordCount;
+    header.deadCount = 0;
+    header.sortedCount = 0;
 
-    std::fstream file(repo_file_name, std::ios::binary | std::ios::in);
-    if (!file) {
-        throw std::runtime_error("Failed to open file for reading.");
+    std::string temp_file_name = repo_file_name + ".tmp";
+    std::ofstream output(temp_file_name, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Failed to open file for writing.");
     }
+    output.write((char*)&header, sizeof(RecordFileHeader));
+    output.write((char*)fileDepartments.data(), fileDepartments.size() * sizeof(FileDepartment));
+    output.close();
+    if (!output || std::rename(temp_file_name.c_str(), repo_file_name.c_str()) != 0) {
+        throw std::runtime_error("Failed to migrate " + repo_file_name + ".");
+    }
+    std::remove(id_index_file_name.c_str());
+    std::remove(name_index_file_name.c_str());
+    return true;
+}
 
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
+void DepartmentFileRepo::Refresh_()
+{
+    store.Refresh();
+    id_index.Refresh();
+    name_index.Refresh();
 
-    if (fileSize == 0)
-    {
-        file.close();
-        return 0; 
+    size_t live = store.Count() - store.DeadCount();
+    if (id_index.Count() != live) {
+        RebuildIdIndex_();
+    }
+    if (name_index.Count() != live) {
+        RebuildNameIndex_();
     }
+}
 
-    size_t lastRecordPos = fileSize - sizeof(FileDepartment);
+// Index missing, from an older file or left behind by a crash.
+void DepartmentFileRepo::RebuildIdIndex_()
+{
+    std::vector<IdIndexEntry> entries;
+    for (size_t slot = 0; slot < store.Count(); slot++) {
+        if (!store.At(slot).IsDeleted()) {
+            entries.push_back(IdIndexEntry { store.At(slot).id, static_cast<int>(slot) });
+        }
+    }
+    id_index.Clear();
+    id_index.InsertMany(entries);
+}
 
-    file.seekg(lastRecordPos, std::ios::beg);
+void DepartmentFileRepo::RebuildNameIndex_()
+{
+    std::vector<NameIndexEntry> entries;
+    for (size_t slot = 0; slot < store.Count(); slot++) {
+        if (!store.At(slot).IsDeleted()) {
+            entries.push_back(MakeNameIndexEntry_(store.At(slot), slot));
+        }
+    }
+    name_index.Clear();
+    name_index.InsertMany(entries);
+}
 
-    FileDepartment fileDepartment;
-    file.read((char*)&fileDepartment, sizeof(FileDepartment));
+NameIndexEntry DepartmentFileRepo::MakeNameIndexEntry_(const FileDepartment& fileDepartment, size_t slot)
+{
+    NameIndexEntry entry {};
+    entry.id = fileDepartment.id;
+    entry.slot = static_cast<int>(slot);
+    std::strncpy(entry.name, fileDepartment.name, sizeof(entry.name) - 1);
+    return entry;
+}
 
-    file.close();
-    return fileDepartment.id;
+void DepartmentFileRepo::CompactIfNeeded_()
+{
+    if (store.DeadCount() * 100 >= store.Count() * compact_dead_percent) {
+        Compact();
+    }
 }
 
 //
 void DepartmentFileRepo::Create(Department& entity)
 {
-    int lastId = GetLastId_();
-    std::ofstream output(repo_file_name, std::ios::binary | std::ios::app);
-    if (!output) {
-        throw std::runtime_error("Failed to open file for writing.");
-    }
+    Refresh_();
     //
-    entity.SetId(lastId + 1);
+    entity.SetId(store.NextId());
     FileDepartment fileAccount = DepartmentConverter::ConvertDepartmentToFileDepartment(entity);
     //
-    output.write((char*)&fileAccount, sizeof(fileAccount));
-    output.close();
+    store.Append(fileAccount);
+    id_index.Insert(fileAccount.id, store.Count() - 1);
+    name_index.Insert(fileAccount.name, fileAccount.id, store.Count() - 1);
+}
+
+// Ids for the whole batch up front, then one append to the store and
+// one merge per index.
+void DepartmentFileRepo::CreateMany(std::vector<Department>& entities)
+{
+    Refresh_();
+
+    std::vector<FileDepartment> fileDepartments;
+    std::vector<IdIndexEntry> idEntries;
+    std::vector<NameIndexEntry> nameEntries;
+    fileDepartments.reserve(entities.size());
+    idEntries.reserve(entities.size());
+    nameEntries.reserve(entities.size());
+
+    size_t slot = store.Count();
+    for (Department& entity : entities) {
+        entity.SetId(store.NextId());
+        FileDepartment fileDepartment = DepartmentConverter::ConvertDepartmentToFileDepartment(entity);
+        idEntries.push_back(IdIndexEntry { fileDepartment.id, static_cast<int>(slot) });
+        nameEntries.push_back(MakeNameIndexEntry_(fileDepartment, slot));
+        fileDepartments.push_back(fileDepartment);
+        slot++;
+    }
+
+    store.AppendMany(fileDepartments.data(), fileDepartments.size());
+    id_index.InsertMany(idEntries);
+    name_index.InsertMany(nameEntries);
 }
 
 std::vector<Department> DepartmentFileRepo::ReadAll() {
-    CreateFile_(); // Ensure the file exists
+    Refresh_();
     std::vector<Department> matchingDepartments;
+    matchingDepartments.reserve(store.Count());
 
-    std::ifstream input(repo_file_name, std::ios::binary);
-    if (!input) {
-        throw std::runtime_error("Failed to open file for reading.");
-    }
-
-    FileDepartment fileDepartment;
-    while (input.read((char*)&fileDepartment, sizeof(FileDepartment))) {
+    for (const FileDepartment& fileDepartment : store) {
+        if (fileDepartment.IsDeleted()) {
+            continue;
+        }
         matchingDepartments.push_back(DepartmentConverter::ConvertFileDepartmentToDepartment(fileDepartment));
     }
-    input.close();
     return matchingDepartments;
 }
 
 //
 std::vector<Department> DepartmentFileRepo::SearchByName(const std::string& name) {
-    CreateFile_(); // Ensure the file exists
+    Refresh_();
     std::vector<Department> matchingDepartments;
 
-    std::ifstream input(repo_file_name, std::ios::binary);
-    if (!input) {
-        throw std::runtime_error("Failed to open file for reading.");
+    for (size_t slot : name_index.FindExact(name)) {
+        matchingDepartments.push_back(DepartmentConverter::ConvertFileDepartmentToDepartment(store.At(slot)));
     }
+    return matchingDepartments;
+}
 
-    FileDepartment fileDepartment;
-    while (input.read((char*)&fileDepartment, sizeof(FileDepartment))) {
-        // Compare names using strcmp for C-style strings
-        if (strcmp(fileDepartment.name, name.c_str()) == 0) {
-            // Convert FileDepartment to Department and add to the vector
-            matchingDepartments.push_back(DepartmentConverter::ConvertFileDepartmentToDepartment(fileDepartment));
-        }
+std::vector<Department> DepartmentFileRepo::SearchByNamePrefix(const std::string& prefix) {
+    Refresh_();
+    std::vector<Department> matchingDepartments;
+
+    for (size_t slot : name_index.FindPrefix(prefix)) {
+        matchingDepartments.push_back(DepartmentConverter::ConvertFileDepartmentToDepartment(store.At(slot)));
     }
-    input.close();
     return matchingDepartments;
 }
 
 Department DepartmentFileRepo::ReadByName(std::string name)
 {
-    CreateFile_(); 
-
-    std::ifstream input(repo_file_name, std::ios::binary);
-    if (!input) {
-        throw std::runtime_error("Failed to open file for reading.");
-    }
-
-    FileDepartment fileDepartment;
+    Refresh_();
 
-    while (input.read((char*)&fileDepartment, sizeof(FileDepartment))) {
-        
-        if (name == fileDepartment.name) {
-            input.close();
-            return DepartmentConverter::ConvertFileDepartmentToDepartment(fileDepartment);
-        }
+    std::vector<size_t> slots = name_index.FindExact(name);
+    if (!slots.empty()) {
+        return DepartmentConverter::ConvertFileDepartmentToDepartment(store.At(slots.front()));
     }
 
-    input.close();
     throw std::runtime_error("Department with given ID not found.");
 }
 
 Department DepartmentFileRepo::ReadById(int id)
 {
-    CreateFile_(); 
-
-    std::ifstream input(repo_file_name, std::ios::binary);
-    if (!input) {
-        throw std::runtime_error("Failed to open file for reading.");
-    }
-
-    FileDepartment fileDepartment;
+    Refresh_();
 
-    while (input.read((char*)&fileDepartment, sizeof(FileDepartment))) {
-        
-        if (id == fileDepartment.id) {
-            input.close();
-            return DepartmentConverter::ConvertFileDepartmentToDepartment(fileDepartment);
-        }
+    size_t slot;
+    if (id_index.Find(id, slot)) {
+        return DepartmentConverter::ConvertFileDepartmentToDepartment(store.At(slot));
     }
 
-    input.close();
     throw std::runtime_error("Department with given ID not found.");
 }
 
 void DepartmentFileRepo::Update(Department& entity)
 {
-    CreateFile_(); 
-
-    std::fstream file(repo_file_name, std::ios::binary | std::ios::in | std::ios::out);
-    if (!file) {
-        throw std::runtime_error("Failed to open file for reading/writing.");
-    }
-
-    FileDepartment fileDepartment;
-    bool updated = false;
-
-    while (file.read((char*)&fileDepartment, sizeof(FileDepartment))) {
-        if (fileDepartment.name == entity.GetName()) { 
+    Refresh_();
 
-            std::strncpy(fileDepartment.description, entity.GetDescription().c_str(), sizeof(fileDepartment.description) - 1);
-            fileDepartment.description[sizeof(fileDepartment.description) - 1] = '\0';  
+    std::vector<size_t> slots = name_index.FindExact(entity.GetName());
+    if (!slots.empty()) {
+        FileDepartment& fileDepartment = store.Modify(slots.front());
 
-            file.seekp(static_cast<std::streamoff>(file.tellg()) - sizeof(FileDepartment));
-            file.write((char*)&fileDepartment, sizeof(FileDepartment));
-            updated = true;
-            break;
-        }
+        std::strncpy(fileDepartment.description, entity.GetDescription().c_str(), sizeof(fileDepartment.description) - 1);
+        fileDepartment.description[sizeof(fileDepartment.description) - 1] = '\0';
+        return;
     }
 
-    file.close();
-
-    if (!updated) {
-        throw std::runtime_error("Department with given name not found.");
-    }
+    throw std::runtime_error("Department with given name not found.");
 }
 
 void DepartmentFileRepo::DeleteByName(const std::string& name)
 {
-    CreateFile_(); 
-
-    std::fstream file(repo_file_name, std::ios::binary | std::ios::in | std::ios::out);
-    if (!file) {
-        throw std::runtime_error("Failed to open file for reading/writing.");
-    }
-
-    std::vector<FileDepartment> departments;
-    FileDepartment fileDepartment;
-    bool found = false;
-
-    while (file.read((char*)&fileDepartment, sizeof(FileDepartment))) {
-        if (fileDepartment.name == name) {
-            found = true; 
-        } else {
-            departments.push_back(fileDepartment);  
-        }
-    }
+    Refresh_();
 
-    file.close();
+    std::vector<size_t> slots = name_index.FindExact(name);
 
-    if (!found) {
+    if (slots.empty()) {
         throw std::runtime_error("Department with the given name not found.");
     }
 
-    std::ofstream output(repo_file_name, std::ios::binary | std::ios::trunc);
-    if (!output) {
-        throw std::runtime_error("Failed to open file for writing.");
+    for (size_t slot : slots) {
+        const FileDepartment& fileDepartment = store.At(slot);
+        id_index.Erase(fileDepartment.id);
+        name_index.Erase(fileDepartment.name, fileDepartment.id);
+        store.Kill(slot);
     }
 
-    for (const auto& dept : departments) {
-        output.write((char*)&dept, sizeof(FileDepartment));
-    }
+    CompactIfNeeded_();
+}
 
-    output.close();
-}
\ No newline at end of file
+// Drop tombstones from Department.dat; slots move, so both indexes are rebuilt.
+void DepartmentFileRepo::Compact()
+{
+    Refresh_();
+
+    store.Compact();
+    RebuildIdIndex_();
+    RebuildNameIndex_();
+}
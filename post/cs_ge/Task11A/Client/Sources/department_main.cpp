@@ -24,6 +24,10 @@ void DepartmentUi::Create(Department& department) {
     department.SetDescription(description);
 }
 
+std::string DepartmentUi::ReadSearchText() {
+    return uiCommon.in.Str("Enter Department Name (or its beginning):");
+}
+
 void DepartmentUi::Display(std::vector<Department>& departments) {
     //Display departments table
     uiCommon.Line('~');
@@ -65,12 +69,23 @@ void DepartmentController::Display() {
     uiCommon.PressAnyKey(true);
 }
 
+void DepartmentController::Search() {
+    uiCommon.TitleBar("Department Management > Search Departments", '#');
+
+    std::string prefix = view.ReadSearchText();
+    std::vector<Department> departments = repo.SearchByNamePrefix(prefix);
+    view.Display(departments);
+
+    uiCommon.PressAnyKey(true);
+}
+
 //class DepartmentPage
 int DepartmentPage::ReadMenu_() {
     std::string caption = "Department Management";
     std::vector<std::string> menuOptions {
         "1 - Create Department",
         "2 - Display Departments",
+        "3 - Search Departments",
         "99 - Exit"
     };
 
@@ -91,6 +106,9 @@ void DepartmentPage::Main() {
             } break;
             case 2: {
                 controller.Display();
+            } break;
+            case 3: {
+                controller.Search();
             } break;            
             case 99: {
                 //Exit
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "./../Headers/id_index.h"
+
+//class IdIndex
+IdIndex::IdIndex(const std::string& fileName)
+    : entries(fileName, 1 << 16)
+{
+}
+
+size_t IdIndex::LowerBound_(int id)
+{
+    size_t low = 0;
+    size_t high = entries.Count();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (entries.At(mid).id < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void IdIndex::Refresh()
+{
+    entries.Refresh();
+}
+
+// Live entries only.
+size_t IdIndex::Count() const
+{
+    return entries.Count() - entries.DeadCount();
+}
+
+void IdIndex::Clear()
+{
+    entries.Clear();
+}
+
+bool IdIndex::Find(int id, size_t& slot)
+{
+    size_t pos = LowerBound_(id);
+    if (pos == entries.Count() || entries.At(pos).id != id || entries.At(pos).IsDeleted()) {
+        return false;
+    }
+    slot = static_cast<size_t>(entries.At(pos).slot);
+    return true;
+}
+
+void IdIndex::Insert(int id, size_t slot)
+{
+    IdIndexEntry entry { id, static_cast<int>(slot) };
+    // New ids are handed out in increasing order, so this is an append.
+    if (entries.Count() == 0 || entries.At(entries.Count() - 1).id < id) {
+        entries.Append(entry);
+        return;
+    }
+    size_t pos = LowerBound_(id);
+    if (pos < entries.Count() && entries.At(pos).id == id) {
+        entries.Revive(pos, entry);
+        return;
+    }
+    std::vector<IdIndexEntry> one { entry };
+    InsertMany(one);
+}
+
+// Merge a batch in one pass instead of shifting the array per entry.
+void IdIndex::InsertMany(std::vector<IdIndexEntry>& newEntries)
+{
+    std::sort(newEntries.begin(), newEntries.end(),
+        [](const IdIndexEntry& a, const IdIndexEntry& b) { return a.id < b.id; });
+
+    if (newEntries.empty()) {
+        return;
+    }
+    if (entries.Count() == 0 || entries.At(entries.Count() - 1).id < newEntries.front().id) {
+        entries.AppendMany(newEntries.data(), newEntries.size());
+        return;
+    }
+
+    // the rewrite drops tombstones
+    std::vector<IdIndexEntry> live;
+    live.reserve(Count());
+    std::copy_if(entries.begin(), entries.end(), std::back_inserter(live),
+        [](const IdIndexEntry& entry) { return !entry.IsDeleted(); });
+    std::vector<IdIndexEntry> merged;
+    merged.reserve(live.size() + newEntries.size());
+    std::merge(live.begin(), live.end(), newEntries.begin(), newEntries.end(),
+        std::back_inserter(merged),
+        [](const IdIndexEntry& a, const IdIndexEntry& b) { return a.id < b.id; });
+    entries.Clear();
+    entries.AppendMany(merged.data(), merged.size());
+}
+
+// Tombstone in place: no shifting of the entries after it.
+void IdIndex::Erase(int id)
+{
+    size_t pos = LowerBound_(id);
+    if (pos < entries.Count() && entries.At(pos).id == id) {
+        entries.Kill(pos);
+    }
+}
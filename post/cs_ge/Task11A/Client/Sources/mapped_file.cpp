@@ -0,0 +1,89 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "./../Headers/mapped_file.h"
+
+//class MappedFile
+MappedFile::MappedFile(const std::string& fileName, size_t chunkSize)
+    : chunkSize(chunkSize)
+{
+    fd = open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file " + fileName + ".");
+    }
+    Refresh();
+}
+
+MappedFile::~MappedFile()
+{
+    Sync();
+    Unmap_();
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void MappedFile::Map_(size_t newSize)
+{
+    Unmap_();
+    if (newSize == 0) {
+        return;
+    }
+    void* addr = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file.");
+    }
+    data = static_cast<char*>(addr);
+    size = newSize;
+}
+
+void MappedFile::Unmap_()
+{
+    if (data != nullptr) {
+        munmap(data, size);
+    }
+    data = nullptr;
+    size = 0;
+}
+
+// Grow the file to hold at least `bytes`, rounded up to a whole chunk,
+// so that appends only pay for ftruncate + remap once per chunk.
+void MappedFile::Reserve(size_t bytes)
+{
+    Refresh();
+    if (bytes <= size) {
+        return;
+    }
+    size_t newSize = ((bytes + chunkSize - 1) / chunkSize) * chunkSize;
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+        throw std::runtime_error("Failed to grow file.");
+    }
+    Map_(newSize);
+}
+
+// Remap when another handle has grown the file. Returns true if remapped.
+bool MappedFile::Refresh()
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        throw std::runtime_error("Failed to stat file.");
+    }
+    size_t fileSize = static_cast<size_t>(st.st_size);
+    if (fileSize == size) {
+        return false;
+    }
+    Map_(fileSize);
+    return true;
+}
+
+void MappedFile::Sync()
+{
+    if (data != nullptr) {
+        msync(data, size, MS_SYNC);
+    }
+}
@@ -0,0 +1,205 @@
+#include <cstring>
+
+#include <algorithm>
+#include <iterator>
+
+#include <string>
+#include <vector>
+
+#include "./../Headers/name_index.h"
+
+static int CompareEntry(const NameIndexEntry& entry, const char* name, int id)
+{
+    int byName = strcmp(entry.name, name);
+    if (byName != 0) {
+        return byName;
+    }
+    return (entry.id < id) ? -1 : (entry.id > id) ? 1 : 0;
+}
+
+static bool LessEntry(const NameIndexEntry& a, const NameIndexEntry& b)
+{
+    return CompareEntry(a, b.name, b.id) < 0;
+}
+
+//class NameIndex
+NameIndex::NameIndex(const std::string& fileName)
+    : entries(fileName, 1 << 16)
+{
+    if (entries.Count() - entries.SortedCount() > TAIL_LIMIT) {
+        Merge_();
+    }
+}
+
+// First position of the sorted part whose (name, id) is not less than the given key.
+size_t NameIndex::LowerBound_(const char* name, int id)
+{
+    size_t low = 0;
+    size_t high = entries.SortedCount();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (CompareEntry(entries.At(mid), name, id) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Every live entry in key order: the sorted part merged with the sorted tail.
+std::vector<NameIndexEntry> NameIndex::LiveSorted_()
+{
+    const NameIndexEntry* tailBegin = entries.begin() + entries.SortedCount();
+    std::vector<NameIndexEntry> sorted;
+    std::vector<NameIndexEntry> tail;
+    sorted.reserve(Count());
+    std::copy_if(entries.begin(), tailBegin, std::back_inserter(sorted),
+        [](const NameIndexEntry& entry) { return !entry.IsDeleted(); });
+    std::copy_if(tailBegin, entries.end(), std::back_inserter(tail),
+        [](const NameIndexEntry& entry) { return !entry.IsDeleted(); });
+    std::sort(tail.begin(), tail.end(), LessEntry);
+
+    size_t middle = sorted.size();
+    sorted.insert(sorted.end(), tail.begin(), tail.end());
+    std::inplace_merge(sorted.begin(), sorted.begin() + middle, sorted.end(), LessEntry);
+    return sorted;
+}
+
+// Rewrite the file as one sorted run, without tombstones.
+void NameIndex::Merge_()
+{
+    std::vector<NameIndexEntry> merged = LiveSorted_();
+    entries.Clear();
+    entries.AppendMany(merged.data(), merged.size());
+    entries.SetSortedCount(merged.size());
+}
+
+void NameIndex::Refresh()
+{
+    entries.Refresh();
+}
+
+// Live entries only.
+size_t NameIndex::Count() const
+{
+    return entries.Count() - entries.DeadCount();
+}
+
+void NameIndex::Clear()
+{
+    entries.Clear();
+}
+
+// Slots of the live entries matching `match`: binary search from `key` in
+// the sorted part, a scan of the tail, returned in (name, id) order.
+template<class Match>
+std::vector<size_t> NameIndex::Find_(const char* key, Match match)
+{
+    std::vector<NameIndexEntry> found;
+    for (size_t pos = LowerBound_(key, 0); pos < entries.SortedCount(); pos++) {
+        const NameIndexEntry& entry = entries.At(pos);
+        if (!match(entry)) {
+            break;
+        }
+        if (!entry.IsDeleted()) {
+            found.push_back(entry);
+        }
+    }
+    size_t fromSorted = found.size();
+    for (size_t pos = entries.SortedCount(); pos < entries.Count(); pos++) {
+        const NameIndexEntry& entry = entries.At(pos);
+        if (!entry.IsDeleted() && match(entry)) {
+            found.push_back(entry);
+        }
+    }
+    if (found.size() > fromSorted) {
+        std::sort(found.begin(), found.end(), LessEntry);
+    }
+
+    std::vector<size_t> slots;
+    slots.reserve(found.size());
+    for (const NameIndexEntry& entry : found) {
+        slots.push_back(static_cast<size_t>(entry.slot));
+    }
+    return slots;
+}
+
+std::vector<size_t> NameIndex::FindExact(const std::string& name)
+{
+    return Find_(name.c_str(), [&name](const NameIndexEntry& entry) {
+        return strcmp(entry.name, name.c_str()) == 0;
+    });
+}
+
+std::vector<size_t> NameIndex::FindPrefix(const std::string& prefix)
+{
+    return Find_(prefix.c_str(), [&prefix](const NameIndexEntry& entry) {
+        return strncmp(entry.name, prefix.c_str(), prefix.size()) == 0;
+    });
+}
+
+void NameIndex::Insert(const char* name, int id, size_t slot)
+{
+    NameIndexEntry entry {};
+    entry.id = id;
+    entry.slot = static_cast<int>(slot);
+    std::strncpy(entry.name, name, sizeof(entry.name) - 1);
+
+    size_t pos = LowerBound_(entry.name, id);
+    if (pos < entries.SortedCount() && CompareEntry(entries.At(pos), entry.name, id) == 0) {
+        entries.Revive(pos, entry);
+        return;
+    }
+
+    // In order after everything: the sorted part simply grows.
+    bool inOrder = entries.SortedCount() == entries.Count()
+        && (entries.Count() == 0 || LessEntry(entries.At(entries.Count() - 1), entry));
+    entries.Append(entry);
+    if (inOrder) {
+        entries.SetSortedCount(entries.Count());
+    } else if (entries.Count() - entries.SortedCount() >= TAIL_LIMIT) {
+        Merge_();
+    }
+}
+
+// Merge a batch in one pass instead of shifting the array per entry.
+void NameIndex::InsertMany(std::vector<NameIndexEntry>& newEntries)
+{
+    std::sort(newEntries.begin(), newEntries.end(), LessEntry);
+
+    if (newEntries.empty()) {
+        return;
+    }
+    if (entries.SortedCount() == entries.Count()
+            && (entries.Count() == 0 || LessEntry(entries.At(entries.Count() - 1), newEntries.front()))) {
+        entries.AppendMany(newEntries.data(), newEntries.size());
+        entries.SetSortedCount(entries.Count());
+        return;
+    }
+
+    std::vector<NameIndexEntry> live = LiveSorted_();
+    std::vector<NameIndexEntry> merged;
+    merged.reserve(live.size() + newEntries.size());
+    std::merge(live.begin(), live.end(), newEntries.begin(), newEntries.end(),
+        std::back_inserter(merged), LessEntry);
+    entries.Clear();
+    entries.AppendMany(merged.data(), merged.size());
+    entries.SetSortedCount(merged.size());
+}
+
+// Tombstone in place: no shifting of the entries after it.
+void NameIndex::Erase(const char* name, int id)
+{
+    size_t pos = LowerBound_(name, id);
+    if (pos < entries.SortedCount() && CompareEntry(entries.At(pos), name, id) == 0) {
+        entries.Kill(pos);
+        return;
+    }
+    for (pos = entries.SortedCount(); pos < entries.Count(); pos++) {
+        if (CompareEntry(entries.At(pos), name, id) == 0) {
+            entries.Kill(pos);
+            return;
+        }
+    }
+}
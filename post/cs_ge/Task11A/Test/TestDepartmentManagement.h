@@ -39,4 +39,12 @@ TEST_F(TestDepartmentManagement, DepartmentDisplayPage) {
     controller->Display();
 
     EXPECT_NE(output.str().find("Neurology"), std::string::npos) ; 
-}
\ No newline at end of file
+}
+TEST_F(TestDepartmentManagement, DepartmentSearchPage) {
+    std::istringstream input("Neuro\n");
+    std::cin.rdbuf(input.rdbuf());  // Mock input
+
+    controller->Search();
+
+    EXPECT_NE(output.str().find("Neurology"), std::string::npos) ;
+}
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <string>
 #include <gtest/gtest.h>
 #include "./../Client/Headers/department_file_repo.h"
@@ -47,3 +50,127 @@ TEST_F(TestDepartmentRepo, DepartmentCreateAndReadAll) {
     EXPECT_EQ(savedDepartment.GetName(), "Cardiology");
     EXPECT_EQ(savedDepartment.GetDescription(), "Cardiology Dept");
 }
+
+TEST_F(TestDepartmentRepo, DepartmentReadById) {
+    Department department;
+    department.SetName("Oncology");
+    department.SetDescription("Oncology Dept");
+
+    repo->Create(department);
+
+    Department savedDepartment = repo->ReadById(department.GetId());
+
+    EXPECT_EQ(savedDepartment.GetName(), "Oncology");
+    EXPECT_THROW(repo->ReadById(department.GetId() + 1), std::runtime_error);
+}
+
+TEST_F(TestDepartmentRepo, DepartmentReadByIdAfterDelete) {
+    Department removed;
+    removed.SetName("Radiology");
+    removed.SetDescription("Radiology Dept");
+    repo->Create(removed);
+
+    Department kept;
+    kept.SetName("Pathology");
+    kept.SetDescription("Pathology Dept");
+    repo->Create(kept);
+
+    repo->DeleteByName("Radiology");
+
+    EXPECT_THROW(repo->ReadById(removed.GetId()), std::runtime_error);
+    EXPECT_EQ(repo->ReadById(kept.GetId()).GetName(), "Pathology");
+}
+
+TEST_F(TestDepartmentRepo, DepartmentSearchByNamePrefix) {
+    Department paediatrics;
+    paediatrics.SetName("Paediatrics");
+    paediatrics.SetDescription("Paediatrics Dept");
+    repo->Create(paediatrics);
+
+    Department paediatricSurgery;
+    paediatricSurgery.SetName("Paediatric Surgery");
+    paediatricSurgery.SetDescription("Paediatric Surgery Dept");
+    repo->Create(paediatricSurgery);
+
+    std::vector<Department> byPrefix = repo->SearchByNamePrefix("Paediatric");
+    std::vector<Department> byName = repo->SearchByName("Paediatrics");
+
+    ASSERT_GE(byPrefix.size(), 2u);
+    for (Department& department : byPrefix) {
+        EXPECT_EQ(department.GetName().rfind("Paediatric", 0), 0u);
+    }
+    ASSERT_GE(byName.size(), 1u);
+    EXPECT_EQ(byName.back().GetId(), paediatrics.GetId());
+    EXPECT_EQ(repo->ReadByName("Paediatric Surgery").GetName(), "Paediatric Surgery");
+}
+
+TEST_F(TestDepartmentRepo, DepartmentDeleteHidesAndCompacts) {
+    Department kept;
+    kept.SetName("Endocrinology");
+    kept.SetDescription("Endocrinology Dept");
+    repo->Create(kept);
+
+    Department department;
+    department.SetName("Dermatology");
+    department.SetDescription("Dermatology Dept");
+    repo->Create(department);
+
+    repo->DeleteByName("Dermatology");
+
+    EXPECT_TRUE(repo->SearchByName("Dermatology").empty());
+    for (Department& saved : repo->ReadAll()) {
+        EXPECT_NE(saved.GetName(), "Dermatology");
+    }
+    EXPECT_THROW(repo->DeleteByName("Dermatology"), std::runtime_error);
+
+    repo->Compact();
+
+    EXPECT_FALSE(repo->SearchByName("Endocrinology").empty());
+    EXPECT_EQ(repo->ReadById(kept.GetId()).GetName(), "Endocrinology");
+}
+
+TEST_F(TestDepartmentRepo, DepartmentCreateMany) {
+    std::vector<Department> departments(3);
+    departments[0].SetName("Urology");
+    departments[1].SetName("Anaesthesia");
+    departments[2].SetName("Urology");
+    for (Department& department : departments) {
+        department.SetDescription("Bulk Dept");
+    }
+
+    repo->CreateMany(departments);
+
+    EXPECT_EQ(departments[1].GetId(), departments[0].GetId() + 1);
+    EXPECT_EQ(departments[2].GetId(), departments[1].GetId() + 1);
+    EXPECT_EQ(repo->ReadById(departments[1].GetId()).GetName(), "Anaesthesia");
+    EXPECT_EQ(repo->SearchByName("Urology").back().GetId(), departments[2].GetId());
+}
+
+TEST(TestDepartmentRepoMigration, LegacyFileOpensWithItsRecords) {
+    for (const char* fileName : { "Department.dat", "Department.idx", "Department.nidx" }) {
+        std::remove(fileName);
+    }
+    {
+        // the old layout: records back to back, no header, no tombstone
+        std::ofstream legacyFile("Department.dat", std::ios::binary);
+        for (int id = 1; id <= 3; id++) {
+            LegacyFileDepartment legacy {};
+            legacy.id = id;
+            std::strcpy(legacy.name, id == 2 ? "Nephrology" : "Legacy");
+            std::strcpy(legacy.description, "Legacy Dept");
+            legacyFile.write((char*)&legacy, sizeof(legacy));
+        }
+    }
+
+    DepartmentFileRepo repo;
+    Department created;
+    created.SetName("Rheumatology");
+    created.SetDescription("Rheumatology Dept");
+    repo.Create(created);
+
+    EXPECT_EQ(repo.ReadAll().size(), 4u);
+    EXPECT_EQ(repo.ReadById(2).GetName(), "Nephrology");
+    EXPECT_EQ(repo.ReadById(3).GetDescription(), "Legacy Dept");
+    EXPECT_EQ(created.GetId(), 4);
+    EXPECT_EQ(repo.SearchByName("Legacy").size(), 2u);
+}
@@ -1,4 +1,5 @@
 #include "TestDepartmentModel.h"
+#include "TestRecordFile.h"
 #include "TestDepartmentRepo.h"
 #include "TestDepartmentManagement.h"
 #include <gtest/gtest.h>
@@ -0,0 +1,165 @@
+#pragma once
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include "./../Client/Headers/record_file.h"
+#include "./../Client/Headers/department.h"
+#include "./../Client/Headers/id_index.h"
+#include "./../Client/Headers/name_index.h"
+
+class TestRecordFile : public testing::Test {
+protected:
+    const std::string file_name = "RecordFileTest.dat";
+
+    FileDepartment MakeRecord(int id, const char* name) {
+        FileDepartment record {};
+        record.id = id;
+        std::strcpy(record.name, name);
+        return record;
+    }
+
+    void SetUp() override {
+        std::remove(file_name.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(file_name.c_str());
+    }
+};
+
+TEST_F(TestRecordFile, AppendGrowsAcrossChunks) {
+    RecordFile<FileDepartment> store(file_name, 4096);
+    for (int id = 1; id <= 100; id++) {
+        store.Append(MakeRecord(id, "Dept"));
+    }
+
+    EXPECT_EQ(store.Count(), 100u);
+    EXPECT_EQ(store.At(0).id, 1);
+    EXPECT_EQ(store.At(99).id, 100);
+}
+
+TEST_F(TestRecordFile, ReopenAndRefreshSeeSameRecords) {
+    RecordFile<FileDepartment> writer(file_name, 4096);
+    writer.Append(MakeRecord(1, "Cardiology"));
+
+    RecordFile<FileDepartment> reader(file_name, 4096);
+    EXPECT_EQ(reader.Count(), 1u);
+
+    for (int id = 2; id <= 50; id++) {
+        writer.Append(MakeRecord(id, "Neurology"));
+    }
+    reader.Refresh();
+
+    EXPECT_EQ(reader.Count(), 50u);
+    EXPECT_STREQ(reader.At(49).name, "Neurology");
+}
+
+TEST_F(TestRecordFile, KillKeepsSlotUntilCompact) {
+    RecordFile<FileDepartment> store(file_name, 4096);
+    store.Append(MakeRecord(1, "A"));
+    store.Append(MakeRecord(2, "B"));
+    store.Append(MakeRecord(3, "C"));
+
+    store.Kill(0);
+    store.Kill(0);
+
+    EXPECT_EQ(store.Count(), 3u);
+    EXPECT_EQ(store.DeadCount(), 1u);
+    EXPECT_TRUE(store.At(0).IsDeleted());
+
+    store.Compact();
+
+    EXPECT_EQ(store.Count(), 2u);
+    EXPECT_EQ(store.DeadCount(), 0u);
+    EXPECT_EQ(store.At(0).id, 2);
+    EXPECT_EQ(store.At(1).id, 3);
+}
+
+TEST_F(TestRecordFile, HeaderKeepsNextIdAcrossReopen) {
+    {
+        RecordFile<FileDepartment> store(file_name, 4096);
+        store.Append(MakeRecord(store.NextId(), "A"));
+        store.Append(MakeRecord(store.NextId(), "B"));
+        store.Kill(1);
+        store.Compact();
+    }
+
+    RecordFile<FileDepartment> store(file_name, 4096);
+
+    EXPECT_EQ(store.Count(), 1u);
+    EXPECT_EQ(store.NextId(), 3);
+}
+
+TEST_F(TestRecordFile, RejectsFileOfOtherLayout) {
+    {
+        RecordFile<IdIndexEntry> other(file_name, 4096);
+    }
+
+    EXPECT_THROW(RecordFile<FileDepartment> store(file_name), std::runtime_error);
+}
+
+TEST_F(TestRecordFile, IdIndexEraseLeavesTombstone) {
+    IdIndex index(file_name);
+    index.Insert(1, 0);
+    index.Insert(2, 1);
+    index.Insert(3, 2);
+
+    index.Erase(2);
+
+    size_t slot;
+    EXPECT_EQ(index.Count(), 2u);
+    EXPECT_FALSE(index.Find(2, slot));
+    EXPECT_TRUE(index.Find(3, slot));
+    EXPECT_EQ(slot, 2u);
+    EXPECT_EQ(RecordFile<IdIndexEntry>(file_name).Count(), 3u);
+}
+
+TEST_F(TestRecordFile, IdIndexInsertOutOfOrderMerges) {
+    IdIndex index(file_name);
+    index.Insert(1, 0);
+    index.Insert(3, 1);
+    index.Insert(5, 2);
+    index.Erase(3);
+
+    index.Insert(2, 3);
+
+    size_t slot;
+    EXPECT_EQ(index.Count(), 3u);
+    EXPECT_TRUE(index.Find(2, slot));
+    EXPECT_EQ(slot, 3u);
+    EXPECT_TRUE(index.Find(5, slot));
+    EXPECT_EQ(slot, 2u);
+    EXPECT_EQ(RecordFile<IdIndexEntry>(file_name).Count(), 3u);   // the merge dropped the tombstone
+}
+
+TEST_F(TestRecordFile, NameIndexFindsTailEntriesInOrder) {
+    {
+        NameIndex index(file_name);
+        index.Insert("Neurology", 1, 0);
+        index.Insert("Cardiology", 2, 1);     // out of order: goes to the tail
+        index.Insert("Cardiac Surgery", 3, 2);
+        index.Insert("Cardiology", 4, 3);
+        index.Erase("Cardiac Surgery", 3);
+    }
+
+    NameIndex index(file_name);
+
+    EXPECT_EQ(index.Count(), 3u);
+    EXPECT_EQ(index.FindExact("Cardiology"), (std::vector<size_t> { 1, 3 }));
+    EXPECT_EQ(index.FindPrefix("Card"), (std::vector<size_t> { 1, 3 }));
+    EXPECT_EQ(index.FindPrefix("N"), (std::vector<size_t> { 0 }));
+    EXPECT_TRUE(index.FindExact("Cardiac Surgery").empty());
+}
+
+TEST_F(TestRecordFile, NameIndexMergesLongTail) {
+    NameIndex index(file_name);
+    for (int id = 3000; id >= 1; id--) {
+        index.Insert(("Dept" + std::to_string(id)).c_str(), id, id - 1);
+    }
+
+    RecordFile<NameIndexEntry> raw(file_name);
+    EXPECT_LT(raw.Count() - raw.SortedCount(), 1024u);
+    EXPECT_EQ(index.FindExact("Dept1"), (std::vector<size_t> { 0 }));
+    EXPECT_EQ(index.FindExact("Dept2999"), (std::vector<size_t> { 2998 }));
+    EXPECT_EQ(index.FindPrefix("Dept300").size(), 2u);   // Dept300, Dept3000
+}